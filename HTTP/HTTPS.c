@@ -16,71 +16,36 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>    
+#include <strings.h>
+#include "net_config.h"
+#include "eth_driver.h"
 #include "HTTPS.h"
 #include "main.h"
 
-#define HTML_LEN     1024*5                                 //Maximum size of a single web page
+#if (HTTP_CONN_NUM + 1 + 1 > WCHNET_NUM_TCP)     /* + WebSocket + Modbus */
+    #error "HTTP_CONN_NUM Error,Please leave one TCP connection for the WebSocket and one for Modbus"
+#endif
 
-st_http_request http_request;
+#define HTML_LEN     1024*5                                 //Maximum size of a single web page
+#define JSON_LEN     1024                                   //Maximum size of the /json response
+#define JSON_HEAD    224                                    //Room for its headers, in front of the body
 
-u8 *name;                                               //The name of the web page requested by HTTP
 u8 socket;                                              //socket id
 u8 httpweb[200];                                        //The array is used to store the HTTP response message
 char HtmlBuffer[HTML_LEN];                              //Web page send buffer
+char JsonBuffer[JSON_LEN];                              //The /json response, header and body, kept between requests
+u16 JsonStart, JsonLen;                                 //Response in JsonBuffer, JsonLen 0: not built yet
+u32 JsonGeneration;                                     //PARAMETERSGeneration the response was built from
+char JsonETag[16];                                      //Its entity tag, W/"hash of the body"
+st_http_conn HTTP_Conns[WCHNET_NUM_TCP];                //HTTP connections, HTTP_CONN_NUM of them persistent
+u32 HTTP_RouteHash[HTTP_ROUTE_SLOTS - 1];               //HTTP_HASH of each route path
+u8 HTTP_RouteSlot[HTTP_ROUTE_SLOTS];                    //Hash slot -> route + 1, 0: empty
 
 extern u8 HTTPDataBuffer[RECE_BUF_LEN];//MAC address IP address Gateway IP address subnet mask
 
 extern u16 PARAMETERSDataBuffer[NOofPARAMETERS];
 extern const char *PARAMETERSNameBuffer[];
 
-/*********************************************************************
- * @fn      ParseHttpRequest
- *
- * @brief   Analyze the request message, take out the method and assign it to request->method,
- *          and assign the URL to request->URL (with '/')
- *
- * @param   request - data buff,Used to save the content of each part of the post request
- *          buf - POST request
- *
- * @return  none
- */
-void ParseHttpRequest(st_http_request *request, char *buf)
-{
-    char *strptr = buf;
-
-    if (strstr(strptr, "GET") || strstr(strptr, "get")) {       /*browser 'get' request*/
-        request->METHOD = METHOD_GET;
-        strptr += strlen("GET") + 2;
-        memset(buf, 1, strlen("GET"));                          /* clear the request method */
-    }
-    else {
-        request->METHOD = METHOD_ERR;
-        return;
-    }
-    request->URL[MAX_URL_SIZE - 1] = '0';
-    memcpy(request->URL, strptr, MAX_URL_SIZE - 1);
-    strptr = strtok(request->URL, " ");
-    strcpy((char*) request->URL, strptr);
-}
-
-/*********************************************************************
- * @fn      ParseURLType
- *
- * @brief   Parse URL type
- *
- * @param   type - type.
- *          buf - data buff
- *
- * @return  URL type
- */
-void ParseURLType(char *type, char * buf)
-{
-    if (strstr(buf, ".html") || strstr(name, "HTTP")) /* html type */
-        *type = PTYPE_HTML;
-    else
-        *type = PTYPE_ERR;
-}
-
 /*********************************************************************
  * @fn      MakeHttpResponse
  *
@@ -291,119 +256,641 @@ void Data_Send(u8 id, uint8_t *dataptr, uint32_t datalen)
 }
 
 
+#define BUFFER_SIZE 1024
+
+// Function to add a header to the response
+void add_header(char *response, const char *header_name, const char *header_value) {
+    strcat(response, header_name);
+    strcat(response, ": ");
+    strcat(response, header_value);
+    strcat(response, "\r\n");
+}
+
+
+/*********************************************************************
+ * @fn      HTTP_Find
+ *
+ * @brief   HTTP connection of a socket.
+ *
+ * @param   socketid - socket id
+ *
+ * @return  connection, NULL if the socket has none
+ */
+static st_http_conn *HTTP_Find(u8 socketid)
+{
+    for (u8 i = 0; i < WCHNET_NUM_TCP; i++)
+        if (HTTP_Conns[i].Used && (HTTP_Conns[i].Socket == socketid))
+            return &HTTP_Conns[i];
+    return NULL;
+}
+
 /*********************************************************************
- * @fn      strFind
+ * @fn      HTTP_Open
  *
- * @brief   query for a specific string.
+ * @brief   Start serving a new connection. It is kept open between requests
+ *          if less than HTTP_CONN_NUM are, else closed after its first one.
  *
- * @param   str  - source string.
- *          substr - String to be queried.
+ * @param   socketid - socket id
  *
- * @return  The number of data segments contained in the received data
+ * @return  none
  */
-int strFind( char str[], char substr[] )
+void HTTP_Open(u8 socketid)
 {
-    int i, j, check ,count = 0;
-    int len = strlen( str );
-    int sublen = strlen( substr );
-    for( i = 0; i < len; i++ )
+    st_http_conn *c = NULL;
+    u8 kept = 0;
+
+    HTTP_Close(socketid);                                   // A new connection on the same socket id
+    for (u8 i = 0; i < WCHNET_NUM_TCP; i++)
     {
-        check = 1;
-        for( j = 0; j + i < len && j < sublen; j++ )
+        if (HTTP_Conns[i].Used)
+            kept += HTTP_Conns[i].Persistent;
+        else if (c == NULL)
+            c = &HTTP_Conns[i];
+    }
+    if (c == NULL)
+        return;
+
+    memset(c, 0, sizeof(*c));                               // Parser at HTTP_PARSE_METHOD
+    c->Used = 1;
+    c->Socket = socketid;
+    c->Persistent = (kept < HTTP_CONN_NUM);
+    c->Time = LocalTime;
+}
+
+/*********************************************************************
+ * @fn      HTTP_Close
+ *
+ * @brief   Forget a connection, call it when its socket is closed.
+ *
+ * @param   socketid - socket id
+ *
+ * @return  none
+ */
+void HTTP_Close(u8 socketid)
+{
+    st_http_conn *c = HTTP_Find(socketid);
+
+    if (c != NULL)
+        c->Used = 0;
+}
+
+/*********************************************************************
+ * @fn      HTTP_Stream
+ *
+ * @brief   Send what the socket takes of the body being sent from flash,
+ *          HTTP_Poll sends the rest. It is not copied to RAM on the way,
+ *          WCHNET_SocketSend takes it from where it is.
+ *
+ * @param   c - connection
+ *
+ * @return  none
+ */
+static void HTTP_Stream(st_http_conn *c)
+{
+    u32 len = c->TxLen;
+
+    WCHNET_SocketSend(c->Socket, (u8 *) c->Tx, &len);
+    if (len != 0)
+        c->Time = LocalTime;                                // Not idle while it is sent
+    c->Tx += len;
+    c->TxLen -= len;
+    if ((c->TxLen == 0) && c->Close)
+    {
+        c->Used = 0;
+        WCHNET_SocketClose(c->Socket, TCP_CLOSE_NORMAL);
+    }
+}
+
+/*********************************************************************
+ * @fn      HTTP_Poll
+ *
+ * @brief   Go on with the bodies being sent from flash, close the connections
+ *          idle for HTTP_KEEPALIVE_MS, also the ones that never complete
+ *          a request, call it from the main loop.
+ *
+ * @return  none
+ */
+void HTTP_Poll(void)
+{
+    st_http_conn *c;
+
+    for (u8 i = 0; i < WCHNET_NUM_TCP; i++)
+    {
+        c = &HTTP_Conns[i];
+        if (c->Used && c->TxLen)
+            HTTP_Stream(c);
+        if (c->Used && (LocalTime - c->Time > HTTP_KEEPALIVE_MS))
         {
-            if( str[i + j] != substr[j] )
+            c->Used = 0;
+            WCHNET_SocketClose(c->Socket, TCP_CLOSE_NORMAL);
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn      HTTP_Line
+ *
+ * @brief   A line or field of the request is complete in p->Line.
+ *
+ * @param   p - parser
+ *
+ * @return  none
+ */
+static void HTTP_Line(st_http_parser *p)
+{
+    const char *v;
+
+    p->Line[p->Len] = '\0';
+    switch (p->State)
+    {
+        case HTTP_PARSE_METHOD:                             // Method, up to the space
+            p->Request.METHOD = (strcasecmp(p->Line, "GET") == 0) ? METHOD_GET : METHOD_ERR;
+            p->Hash = HTTP_HASH_INIT;
+            p->State = HTTP_PARSE_URL;
+            break;
+
+        case HTTP_PARSE_VERSION:                            // HTTP/1.1 keeps the connection by default
+            p->Keep = (strcmp(p->Line, "HTTP/1.1") == 0);
+            p->State = HTTP_PARSE_HEADER;
+            break;
+
+        case HTTP_PARSE_HEADER:
+            if (p->Len == 0)                                // Empty line, end of the headers
             {
-                check = 0;
+                p->State = p->Body ? HTTP_PARSE_BODY : HTTP_PARSE_DONE;
                 break;
             }
-        }
-        if( check == 1 )
+            if (strncasecmp(p->Line, "Connection:", 11) == 0)
+            {
+                for (v = &p->Line[11]; *v == ' '; v++);
+                if (strncasecmp(v, "keep-alive", 10) == 0)
+                    p->Keep = 1;
+                else if (strncasecmp(v, "close", 5) == 0)
+                    p->Keep = 0;
+            }
+            else if (strncasecmp(p->Line, "Content-Length:", 15) == 0)
+                p->Body = strtoul(&p->Line[15], NULL, 10);
+            else if (strncasecmp(p->Line, "Accept-Encoding:", 16) == 0)     // A line cut short may have gzip further on
+                p->Plain = (strstr(&p->Line[16], "gzip") == NULL) && (p->Len < HTTP_LINE_LEN - 1);
+            else if (strncasecmp(p->Line, "If-None-Match:", 14) == 0)
+            {
+                for (v = &p->Line[14]; *v == ' '; v++);
+                strncpy(p->Match, v, sizeof(p->Match) - 1);                 // Cut at HTTP_MATCH_LEN - 1, never matches then
+                p->Match[sizeof(p->Match) - 1] = '\0';
+            }
+            break;
+    }
+    p->Len = 0;
+}
+
+/*********************************************************************
+ * @fn      HTTP_Parse
+ *
+ * @brief   Feed received data to the request parser, up to the end of one
+ *          request. A request may come in any number of segments, several
+ *          requests may come in one (pipelining): call it again with the
+ *          rest once the request is served. Each byte is looked at once.
+ *
+ * @param   p - parser, zeroed for a new connection and after each request
+ *          buf - received data
+ *          len - bytes in buf
+ *
+ * @return  bytes used, p->State is HTTP_PARSE_DONE when the request is complete
+ */
+u32 HTTP_Parse(st_http_parser *p, const u8 *buf, u32 len)
+{
+    u32 i, n;
+    char ch;
+
+    for (i = 0; (i < len) && (p->State != HTTP_PARSE_DONE); i++)
+    {
+        ch = buf[i];
+        switch (p->State)
         {
-            count++;
-            i = i + sublen;
+            case HTTP_PARSE_URL:                            // Up to the space before the version
+                if ((ch == ' ') || (ch == '\n'))
+                {
+                    p->Request.URL[p->Len] = '\0';
+                    p->Len = 0;
+                    p->State = (ch == ' ') ? HTTP_PARSE_VERSION : HTTP_PARSE_HEADER;
+                }
+                else if (ch != '\r')
+                {
+                    if (ch == '?')
+                        p->Query = 1;
+                    else if (!p->Query)
+                        p->Hash = HTTP_HASH(p->Hash, ch);   // The route is looked up without a scan
+                    if (p->Len < MAX_URL_SIZE - 1)
+                        p->Request.URL[p->Len++] = ch;
+                }
+                break;
+
+            case HTTP_PARSE_BODY:                           // Not served, skipped
+                n = ((len - i) < p->Body) ? (len - i) : p->Body;
+                p->Body -= n;
+                i += n - 1;
+                if (p->Body == 0)
+                    p->State = HTTP_PARSE_DONE;
+                break;
+
+            default:                                        // Method, version and header lines
+                if (ch == '\r')
+                    break;
+                if ((ch == '\n') && (p->State == HTTP_PARSE_METHOD) && (p->Len == 0))
+                    break;                                  // Empty line between requests
+                if ((ch == '\n') || ((ch == ' ') && (p->State == HTTP_PARSE_METHOD)))
+                    HTTP_Line(p);
+                else if (p->Len < HTTP_LINE_LEN - 1)
+                    p->Line[p->Len++] = ch;
+                break;
         }
     }
-    return count;
+    return i;
 }
 
+/*********************************************************************
+ * @fn      HTTP_Head
+ *
+ * @brief   Status line, Content-Type and connection headers of a response.
+ *
+ * @param   buf - output, size - its size, HTTP_HEAD_LEN is enough
+ *          status - RES_xxx status line, type - Content-Type or NULL
+ *          c - connection, keep - 1 if it stays open
+ *
+ * @return  length written
+ */
+static u32 HTTP_Head(char *buf, u32 size, const char *status, const char *type, const st_http_conn *c, u8 keep)
+{
+    u32 n = snprintf(buf, size, "%s", status);
 
+    if (type != NULL)
+        n += snprintf(&buf[n], size - n, "Content-Type: %s\r\n", type);
+    if (keep)
+        n += snprintf(&buf[n], size - n, RES_KEEPALIVE, HTTP_KEEPALIVE_MS / 1000, HTTP_KEEPALIVE_MAX - c->Requests);
+    else
+        n += snprintf(&buf[n], size - n, RES_CLOSE);
+    return n;
+}
 
-#define BUFFER_SIZE 1024
-
-// Function to add a header to the response
-void add_header(char *response, const char *header_name, const char *header_value) {
-    strcat(response, header_name);
-    strcat(response, ": ");
-    strcat(response, header_value);
-    strcat(response, "\r\n");
+/*********************************************************************
+ * @fn      HTTP_Not_Modified
+ *
+ * @brief   Send 304 Not Modified if the client has the current response,
+ *          If-None-Match with its entity tag or "*". The comparison is the
+ *          weak one, W/ is not looked at.
+ *
+ * @param   c - connection, p - parser with the request
+ *          etag - entity tag of the response, keep - 1 if it stays open
+ *
+ * @return  1 if it was sent, 0 if the response must be sent
+ */
+static u8 HTTP_Not_Modified(const st_http_conn *c, const st_http_parser *p, const char *etag, u8 keep)
+{
+    char head[HTTP_HEAD_LEN + 64];
+    u32 n;
+
+    if ((p->Match[0] == '\0') || ((p->Match[0] != '*') && (strstr(p->Match, strchr(etag, '"')) == NULL)))
+        return 0;
+    // No body, the client uses its copy
+    n = HTTP_Head(head, HTTP_HEAD_LEN, RES_NOT_MODIFIED, NULL, c, keep);
+    n += snprintf(&head[n], sizeof(head) - n, "ETag: %s\r\nCache-Control: no-cache" RES_END, etag);
+    Data_Send(socket, (u8 *) head, n);
+    return 1;
 }
 
+/*********************************************************************
+ * @fn      Json_Update
+ *
+ * @brief   Rebuild the /json response in JsonBuffer if PARAMETERSDataBuffer
+ *          changed since it was built, else keep it. The body is written
+ *          once, its ETag, Cache-Control and Content-Length right in front
+ *          of it, and HTTP_HEAD_LEN is left there for the status line and
+ *          the other headers of each request, so the whole response goes
+ *          out with one Data_Send.
+ *          The entity tag is the hash of the body, computed only here: the
+ *          generation counter restarts at 0 with the board, it would give
+ *          the same tag to other values after a reset.
+ *
+ * @return  none
+ */
+void Json_Update(void)
+{
+    char *body = &JsonBuffer[JSON_HEAD];
+    u32 size = JSON_LEN - JSON_HEAD - 1;                    // Room for the closing brace
+    u32 len = 1;
+    u32 hash = HTTP_HASH_INIT;
+    char head[JSON_HEAD - HTTP_HEAD_LEN];
+    int n;
+
+    if ((JsonLen != 0) && (JsonGeneration == PARAMETERSGeneration))
+        return;
+
+    body[0] = '{';
+    for (u8 i = 0; i < NOofPARAMETERS; i++)
+    {
+        n = snprintf(&body[len], size - len, PARAMETERSNameBuffer[i], PARAMETERSDataBuffer[i]);
+        if ((n < 0) || ((u32) n >= size - len))                   // Does not fit, leave it out
+            break;
+        len += n;
+    }
+    body[len++] = '}';
+
+    for (u32 i = 0; i < len; i++)
+        hash = HTTP_HASH(hash, body[i]);
+    snprintf(JsonETag, sizeof(JsonETag), "W/\"%08x\"", (unsigned) hash);
+    n = snprintf(head, sizeof(head), "ETag: %s\r\nCache-Control: no-cache\r\nContent-Length:%u" RES_END,
+                 JsonETag, (unsigned) len);
+    JsonStart = JSON_HEAD - n;
+    memcpy(&JsonBuffer[JsonStart], head, n);
+    JsonLen = n + len;
+    JsonGeneration = PARAMETERSGeneration;
+}
 
+/*********************************************************************
+ * @fn      HTTP_Json
+ *
+ * @brief   Route handler, the parameters as JSON (JsonBuffer).
+ *
+ * @param   route - route, c - connection, p - parser with the request
+ *          keep - 1 if it stays open
+ *
+ * @return  none
+ */
+static void HTTP_Json(const st_http_route *route, const st_http_conn *c, const st_http_parser *p, u8 keep)
+{
+    char head[HTTP_HEAD_LEN];
+    u32 n;
 
+    // Built when the parameters change, else sent as it is
+    Json_Update();
+    if (HTTP_Not_Modified(c, p, JsonETag, keep))            // Not changed since the client got it
+        return;
+    n = HTTP_Head(head, sizeof(head), RES_OK, route->Type, c, keep);
+    memcpy(&JsonBuffer[JsonStart - n], head, n);
+    Data_Send(socket, (u8 *) &JsonBuffer[JsonStart - n], JsonLen + n);
+}
 
 /*********************************************************************
- * @fn      Web_Server
+ * @fn      HTTP_Echo
+ *
+ * @brief   Route handler, the answer to the AJAX request of AJAXClient.html.
  *
- * @brief   web process function.
+ * @param   route - route, c - connection, p - parser with the request
+ *          keep - 1 if it stays open
  *
  * @return  none
  */
-void Web_Server(void)
+static void HTTP_Echo(const st_http_route *route, const st_http_conn *c, const st_http_parser *p, u8 keep)
 {
-    uint8_t reqnum = 0;
-    u32 resplen = 0;
-    u32 pagelen = 0;
+    const char *body = "{\"message\": \"This is a CORS correct AJAX JSON response.\"}";
+    char response[BUFFER_SIZE];
+    char length[8];
+
+    (void) p;                                               // The request is not looked at
+    HTTP_Head(response, sizeof(response), RES_OK, route->Type, c, keep);
+    // Add CORS headers
+    add_header(response, "Access-Control-Allow-Origin", "*");
+    add_header(response, "Access-Control-Allow-Methods", "GET, POST");
+    add_header(response, "Access-Control-Allow-Headers", "Content-Type");
+    snprintf(length, sizeof(length), "%u", (unsigned) strlen(body));
+    add_header(response, "Content-Length", length);         // Needed to keep the connection open
+    strcat(response, "\r\n"); // End of headers
+    // Add JSON body to the answer send to AJAX request
+    strcat(response, body);
+    Data_Send(socket, (u8 *) response, strlen(response));
+}
 
-    char Html_json[1000];
+/* Endpoints, method and exact path. Add one here, HTTP_Route_Init hashes them */
+static const st_http_route HTTP_Routes[] = {
+    /* Method     Path          Handler     Content-Type */
+    { METHOD_GET, "/json",      HTTP_Json,  "application/json" },
+    { METHOD_GET, "/json.html", HTTP_Json,  "text/html" },          // get_JSON.py
+    { METHOD_GET, "/echo",      HTTP_Echo,  "application/json" },   // AJAXClient.html
+};
 
-    // Create JSON buffer with parameters name and data
-    // for the request for JSON data
-    sprintf(Html_json,"{");
-    for (u8 i = 0; i < NOofPARAMETERS; i++)
-	    sprintf(Html_json + strlen(Html_json), PARAMETERSNameBuffer[i], PARAMETERSDataBuffer[i]);
-    sprintf(Html_json + strlen(Html_json),"}\0");
+#define HTTP_ROUTE_NUM    (sizeof(HTTP_Routes) / sizeof(HTTP_Routes[0]))
 
-    reqnum = strFind(HTTPDataBuffer,"GET") + strFind(HTTPDataBuffer,"get") + \
-             strFind(HTTPDataBuffer,"POST") + strFind(HTTPDataBuffer,"post");
+/*********************************************************************
+ * @fn      HTTP_Path_Is
+ *
+ * @brief   Whether a request URL is a path, with or without a query.
+ *
+ * @param   url - request URL, path - route path
+ *
+ * @return  1 if it is
+ */
+static u8 HTTP_Path_Is(const char *url, const char *path)
+{
+    while ((*path != '\0') && (*url == *path))
+        url++, path++;
+    return (*path == '\0') && ((*url == '\0') || (*url == '?'));
+}
 
-    while (reqnum) {
-        reqnum--;
-        ParseHttpRequest(&http_request, HTTPDataBuffer);
+/*********************************************************************
+ * @fn      HTTP_Route_Init
+ *
+ * @brief   Put the routes in the hash slots HTTP_Route looks them up in,
+ *          call it once before the HTTP socket is created.
+ *
+ * @return  0 - routes usable, otherwise 1 + the route that is not (path
+ *          too long, the same as an earlier one, or no slot left)
+ */
+u8 HTTP_Route_Init(void)
+{
+    const char *c;
+    u32 h;
+    u8 i, k, slot;
 
-        switch (http_request.METHOD)
+    memset(HTTP_RouteSlot, 0, sizeof(HTTP_RouteSlot));
+    for (i = 0; i < HTTP_ROUTE_NUM; i++)
+    {
+        if ((i >= HTTP_ROUTE_SLOTS - 1) || (strlen(HTTP_Routes[i].Path) >= MAX_URL_SIZE))
+            return i + 1;                                   // One slot stays empty, it ends a lookup
+
+        for (h = HTTP_HASH_INIT, c = HTTP_Routes[i].Path; *c; c++)
+            h = HTTP_HASH(h, *c);
+        HTTP_RouteHash[i] = h;
+
+        for (slot = h & (HTTP_ROUTE_SLOTS - 1); (k = HTTP_RouteSlot[slot]) != 0; slot = (slot + 1) & (HTTP_ROUTE_SLOTS - 1))
         {
-            case METHOD_ERR:
-                break;
+            if ((HTTP_Routes[k - 1].METHOD == HTTP_Routes[i].METHOD) && (strcmp(HTTP_Routes[k - 1].Path, HTTP_Routes[i].Path) == 0))
+                return i + 1;
+        }
+        HTTP_RouteSlot[slot] = i + 1;
+    }
+    return 0;
+}
 
-            case METHOD_GET:                                        // GET method
-                name = http_request.URL;
-                ParseURLType(&http_request.TYPE, name);
-
-                if(strstr(name, "json") != NULL) {                  // Request for JSON data
-                	pagelen = strlen(Html_json);
-                	copy_flash(Html_json, pagelen);
-                    // Analyze the requested resource type and return the response
-                    MakeHttpResponse(httpweb, http_request.TYPE, pagelen);
-                    resplen = strlen(httpweb);
-                    Data_Send(socket, httpweb, resplen);
-                    Data_Send(socket, HtmlBuffer, pagelen);
-                } else {                                            // AJAX request for data
-                    char response[BUFFER_SIZE] = "HTTP/1.1 200 OK\r\n";
-                    // Add CORS headers
-                    add_header(response, "Access-Control-Allow-Origin", "*");
-                    add_header(response, "Access-Control-Allow-Methods", "GET, POST");
-                    add_header(response, "Access-Control-Allow-Headers", "Content-Type");
-                    add_header(response, "Content-Type", "application/json");
-                    strcat(response, "\r\n"); // End of headers
-                    // Add JSON body to the answer send to AJAX request
-                    strcat(response, "{\"message\": \"This is a CORS correct AJAX JSON response.\"}");
-                    resplen = strlen(response);
-                    Data_Send(socket, response, resplen);
-                }
-                break;
+/*********************************************************************
+ * @fn      HTTP_Route
+ *
+ * @brief   Route of a request, from the hash of its path. The path itself
+ *          is compared only with the route the hash leads to.
+ *
+ * @param   p - parser with a complete request
+ *
+ * @return  route, NULL if there is none
+ */
+static const st_http_route *HTTP_Route(const st_http_parser *p)
+{
+    const st_http_route *r;
+    u8 k, slot;
 
-            default:
-                break;
+    for (slot = p->Hash & (HTTP_ROUTE_SLOTS - 1); (k = HTTP_RouteSlot[slot]) != 0; slot = (slot + 1) & (HTTP_ROUTE_SLOTS - 1))
+    {
+        r = &HTTP_Routes[k - 1];
+        if ((HTTP_RouteHash[k - 1] == p->Hash) && (r->METHOD == p->Request.METHOD) && HTTP_Path_Is(p->Request.URL, r->Path))
+            return r;
+    }
+    return NULL;
+}
+
+/*********************************************************************
+ * @fn      HTTP_Asset
+ *
+ * @brief   Web page in flash of a request, the hash of its path is
+ *          computed by HTTP/pack_assets.py.
+ *
+ * @param   p - parser with a complete request
+ *
+ * @return  page, NULL if there is none
+ */
+static const st_http_asset *HTTP_Asset(const st_http_parser *p)
+{
+    for (u8 i = 0; i < HTTP_ASSET_NUM; i++)
+    {
+        if ((HTTP_Assets[i].Hash == p->Hash) && (p->Request.METHOD == METHOD_GET) && HTTP_Path_Is(p->Request.URL, HTTP_Assets[i].Path))
+            return &HTTP_Assets[i];
+    }
+    return NULL;
+}
+
+/*********************************************************************
+ * @fn      HTTP_Error
+ *
+ * @brief   Send a response without a body.
+ *
+ * @param   c - connection, status - RES_xxx status line
+ *          keep - 1 if the connection stays open
+ *
+ * @return  none
+ */
+static void HTTP_Error(const st_http_conn *c, const char *status, u8 keep)
+{
+    char head[HTTP_HEAD_LEN + 32];
+    u32 n;
+
+    n = HTTP_Head(head, HTTP_HEAD_LEN, status, NULL, c, keep);
+    n += snprintf(&head[n], sizeof(head) - n, "Content-Length: 0" RES_END);
+    Data_Send(socket, (u8 *) head, n);
+}
+
+/*********************************************************************
+ * @fn      HTTP_File
+ *
+ * @brief   Send a web page from flash, its headers are ready made and
+ *          its body is sent from where it is by HTTP_Stream.
+ *
+ * @param   a - page, c - connection, p - parser with the request
+ *          keep - 1 if the connection stays open
+ *
+ * @return  none
+ */
+static void HTTP_File(const st_http_asset *a, st_http_conn *c, const st_http_parser *p, u8 keep)
+{
+    char head[HTTP_HEAD_LEN + HTTP_ASSET_HEAD_LEN];
+    u32 n;
+
+    if (a->Gzip && p->Plain)                                // Only the gzipped body is kept
+    {
+        HTTP_Error(c, RES_NOT_ACCEPTABLE, keep);
+        return;
+    }
+    if (HTTP_Not_Modified(c, p, a->ETag, keep))
+        return;
+    n = HTTP_Head(head, HTTP_HEAD_LEN, RES_OK, NULL, c, keep);
+    memcpy(&head[n], a->Head, a->HeadLen);
+    Data_Send(socket, (u8 *) head, n + a->HeadLen);
+    c->Tx = a->Body;
+    c->TxLen = a->Len;
+    HTTP_Stream(c);
+}
+
+/*********************************************************************
+ * @fn      HTTP_Respond
+ *
+ * @brief   Send the response to a request: its route, else its web page
+ *          in flash, else 404.
+ *
+ * @param   c - connection, p - parser with a complete request
+ *          keep - 1 if the connection stays open
+ *
+ * @return  none
+ */
+static void HTTP_Respond(st_http_conn *c, const st_http_parser *p, u8 keep)
+{
+    const st_http_route *r = HTTP_Route(p);
+    const st_http_asset *a;
+
+    if (r != NULL)
+        r->Handler(r, c, p, keep);
+    else if ((a = HTTP_Asset(p)) != NULL)
+        HTTP_File(a, c, p, keep);
+    else
+        HTTP_Error(c, RES_NOT_FOUND, keep);
+}
+
+/*********************************************************************
+ * @fn      Web_Server
+ *
+ * @brief   web process function, serves the requests completed by the
+ *          data received on socket. A partial request is kept in the
+ *          connection's parser for the next segment.
+ *
+ * @param   len - bytes received in HTTPDataBuffer
+ *
+ * @return  1 to keep the connection open, 0 to close it
+ */
+u8 Web_Server(u32 len)
+{
+    st_http_conn *c = HTTP_Find(socket);
+    st_http_parser *p;
+    u32 pos = 0;
+    u8 keep;
+
+    if (c == NULL)                                          // Not opened by HTTP_Open
+        return 0;
+    p = &c->Parser;
+    c->Time = LocalTime;
+    if (c->Close)                                           // Closed once the body being sent is sent
+        return 1;
+
+    while (pos < len)
+    {
+        pos += HTTP_Parse(p, &HTTPDataBuffer[pos], len - pos);
+        if (p->State != HTTP_PARSE_DONE)                    // All used, the rest comes later
+            break;
+
+        if (c->TxLen != 0)
+        {
+            // Pipelined behind a body not sent yet, it cannot be answered before it:
+            // the connection is closed after it, the client asks again on another one
+            c->Close = 1;
+            return 1;
+        }
+        c->Requests++;
+        // Only GET is parsed, another method closes the connection after the 404
+        keep = c->Persistent && p->Keep && (p->Request.METHOD == METHOD_GET) &&
+               (c->Requests < HTTP_KEEPALIVE_MAX);
+        HTTP_Respond(c, p, keep);
+        memset(p, 0, sizeof(*p));                           // HTTP_PARSE_METHOD
+        if (!keep)
+        {
+            if (c->TxLen == 0)
+                return 0;                                   // Pipelined requests after it are dropped
+            c->Close = 1;                                   // Closed by HTTP_Stream
+            return 1;
         }
     }
+    return 1;
 }
@@ -33,6 +33,24 @@
 #define	PTYPE_ERR		          0
 #define	PTYPE_HTML	              1
 
+/* HTTP persistent connections */
+#define HTTP_CONN_NUM             1     /* Connections kept open, one TCP PCB is left for the WebSocket, one for Modbus */
+#define HTTP_KEEPALIVE_MS         2000  /* Idle connection closed after, in ms */
+#define HTTP_KEEPALIVE_MAX        100   /* Requests served on one connection, then it is closed */
+#define HTTP_LINE_LEN             48    /* Request header line kept by the parser, the rest is cut */
+#define HTTP_HEAD_LEN             128   /* Status line, Content-Type and connection headers of a response */
+#define HTTP_ASSET_HEAD_LEN       192   /* Other headers of a web page in flash, see HTTP/pack_assets.py */
+#define HTTP_MATCH_LEN            24    /* If-None-Match value kept by the parser, a longer one is cut */
+#define HTTP_ROUTE_SLOTS          16    /* Hash slots of the route table, a power of 2 above the number of routes */
+
+/* HTTP request parser state */
+#define HTTP_PARSE_METHOD         0
+#define HTTP_PARSE_URL            1
+#define HTTP_PARSE_VERSION        2
+#define HTTP_PARSE_HEADER         3
+#define HTTP_PARSE_BODY           4
+#define HTTP_PARSE_DONE           5     /* A request is complete */
+
 /*WCHNET communication Mode*/
 #define MODE_TCPSERVER            0
 #define MODE_TCPCLIENT            1
@@ -42,6 +60,13 @@
 
 #define RES_END "\r\n\r\n"
 
+#define RES_OK "HTTP/1.1 200 OK\r\n"
+#define RES_NOT_MODIFIED "HTTP/1.1 304 Not Modified\r\n"
+#define RES_NOT_FOUND "HTTP/1.1 404 Not Found\r\n"
+#define RES_NOT_ACCEPTABLE "HTTP/1.1 406 Not Acceptable\r\n"
+#define RES_KEEPALIVE "Connection: keep-alive\r\nKeep-Alive: timeout=%u, max=%u\r\n"
+#define RES_CLOSE "Connection: close\r\n"
+
 typedef struct _st_http_request                 //Browser request information
 {
 	char	METHOD;					
@@ -49,23 +74,72 @@ typedef struct _st_http_request                 //Browser request information
 	char	URL[MAX_URL_SIZE];
 }st_http_request;
 
+typedef struct _st_http_parser                 //Request being received, kept between segments
+{
+	u8	State;                                  //HTTP_PARSE_xxx
+	u8	Len;                                    //Bytes in Line, or in Request.URL
+	u8	Keep;                                   //The client wants the connection kept open
+	u32	Body;                                   //Body bytes still to skip
+	u32	Hash;                                   //HTTP_HASH of the path, the URL up to '?'
+	u8	Query;                                  //'?' received, the rest of the URL is not hashed
+	u8	Plain;                                  //Accept-Encoding without gzip
+	char	Match[HTTP_MATCH_LEN];              //If-None-Match, entity tags the client has
+	st_http_request	Request;
+	char	Line[HTTP_LINE_LEN];                //Method, version or header line
+}st_http_parser;
+
+typedef struct _st_http_conn                   //Connection
+{
+	u8	Used;
+	u8	Socket;                                 //socket id
+	u8	Persistent;                             //Kept open between requests (keep-alive)
+	u16	Requests;                               //Requests served
+	u32	Time;                                   //LocalTime of the last request or data sent
+	const u8	*Tx;                            //Rest of a body being sent from flash, see HTTP_Stream
+	u32	TxLen;
+	u8	Close;                                  //Close once the body is sent
+	st_http_parser	Parser;
+}st_http_conn;
+
+typedef struct _st_http_route                  //Endpoint, see HTTP_Routes[] in HTTPS.c
+{
+	char	METHOD;                             //METHOD_xxx
+	const char	*Path;                          //Exact path, a query after it is allowed
+	void	(*Handler)(const struct _st_http_route *route, const st_http_conn *c, const st_http_parser *p, u8 keep);
+	const char	*Type;                          //Content-Type of the response
+}st_http_route;
+
+typedef struct _st_http_asset                  //Web page in flash, see HTTP/pack_assets.py
+{
+	u32	Hash;                                   //HTTP_HASH of Path
+	const char	*Path;
+	u8	Gzip;                                   //Body is gzipped
+	const char	*Head;                          //Content-xxx, ETag and Cache-Control headers, up to the empty line
+	const char	*ETag;                          //Its entity tag, quoted
+	u16	HeadLen;
+	const u8	*Body;
+	u32	Len;
+}st_http_asset;
+
+/* FNV-1a, one byte at a time as the URL is received */
+#define HTTP_HASH_INIT            2166136261u
+#define HTTP_HASH(h, ch)          (((h) ^ (u8)(ch)) * 16777619u)
+
 typedef struct Para_Tab                         //Configuration information parameter table
 {
 	char *para;                                 //Configuration item name
 	char value[30];                             //Configuration item value
 }Parameter;
 
-extern st_http_request http_request;
-
 extern u8 httpweb[200] ;
 
 extern u8 HTTPDataBuffer[];
 
-extern u8 socket;
+extern const st_http_asset HTTP_Assets[];
 
-extern void ParseHttpRequest(st_http_request *, char *);	
+extern const u8 HTTP_ASSET_NUM;
 
-extern void ParseURLType(char *, char *);
+extern u8 socket;
 
 void MakeHttpResponse(u8 *buf, char type, u32 len );
 
@@ -77,7 +151,19 @@ extern void copy_flash(const char *html, u32 len);
 
 extern void Init_Para_Tab(void) ;
 
-extern void Web_Server(void);
+extern void Json_Update(void);
+
+extern u8 HTTP_Route_Init(void);
+
+extern u32 HTTP_Parse(st_http_parser *p, const u8 *buf, u32 len);
+
+extern u8 Web_Server(u32 len);
+
+extern void HTTP_Open(u8 socketid);
+
+extern void HTTP_Close(u8 socketid);
+
+extern void HTTP_Poll(void);
 
 extern void WEB_ERASE(u32 Page_Address, u32 Length );
 
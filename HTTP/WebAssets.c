@@ -0,0 +1,241 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : WebAssets.c
+ * Description : Web pages served from flash, generated by HTTP/pack_assets.py,
+ *               do not edit.
+*********************************************************************************/
+#include "HTTPS.h"
+
+/* /AJAXClient.html, AJAXClient.html, 1969 bytes, 812 gzipped */
+static const u8 Asset_0[812] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x55, 0xdf, 0x4f, 0xdb, 0x30,
+    0x10, 0x7e, 0x66, 0xd2, 0xfe, 0x87, 0x5b, 0x5e, 0x5a, 0x04, 0x24, 0x14, 0x4d, 0x13, 0x83, 0xa4,
+    0xd3, 0x06, 0xdd, 0x60, 0x82, 0x81, 0xa0, 0x48, 0xdb, 0xa3, 0x1b, 0x5f, 0x1b, 0x6f, 0xae, 0x9d,
+    0xd9, 0x4e, 0x0b, 0x9a, 0xf8, 0xdf, 0x77, 0xce, 0x8f, 0x96, 0x36, 0x05, 0x69, 0x0f, 0xf3, 0x4b,
+    0x62, 0xfb, 0xee, 0xfc, 0x7d, 0xe7, 0xef, 0xce, 0xf1, 0x9b, 0xd3, 0xab, 0x93, 0xe1, 0x8f, 0xeb,
+    0x01, 0x64, 0x6e, 0x2a, 0xfb, 0xaf, 0x5f, 0xc5, 0xfe, 0x0b, 0x92, 0xa9, 0x49, 0x12, 0xa0, 0x0a,
+    0xca, 0x15, 0x64, 0x9c, 0xbe, 0x40, 0x23, 0x9e, 0xa2, 0x63, 0x90, 0x66, 0xcc, 0x58, 0x74, 0x49,
+    0x70, 0x37, 0xfc, 0xbc, 0x77, 0x18, 0xac, 0xec, 0x29, 0x36, 0xc5, 0x24, 0x98, 0x09, 0x9c, 0xe7,
+    0xda, 0xb8, 0x00, 0x52, 0xad, 0x1c, 0x2a, 0xb2, 0x9d, 0x0b, 0xee, 0xb2, 0x84, 0xe3, 0x4c, 0xa4,
+    0xb8, 0x57, 0x4e, 0x76, 0x41, 0x28, 0xe1, 0x04, 0x93, 0x7b, 0x36, 0x65, 0x12, 0x93, 0x5e, 0xb8,
+    0xbf, 0x88, 0xe5, 0x84, 0x93, 0xd8, 0xff, 0xf8, 0xf5, 0xe3, 0x77, 0x18, 0xdc, 0xb3, 0x69, 0x2e,
+    0x31, 0x8e, 0xaa, 0xb5, 0xda, 0xc0, 0xa6, 0x46, 0xe4, 0xae, 0x9e, 0xf9, 0x31, 0x2e, 0x54, 0xea,
+    0x84, 0x56, 0x60, 0x51, 0xf1, 0x53, 0xe6, 0x58, 0x77, 0x1b, 0xfe, 0x2c, 0xb7, 0xfd, 0x88, 0x22,
+    0x38, 0x31, 0xc8, 0x1c, 0x02, 0xe1, 0xc4, 0x39, 0x7c, 0xbf, 0xbc, 0x38, 0x73, 0x2e, 0xbf, 0xc1,
+    0xdf, 0x05, 0x5a, 0x07, 0x7a, 0xf4, 0x13, 0x53, 0xb7, 0xea, 0x32, 0x63, 0x06, 0xee, 0x33, 0x03,
+    0xc9, 0x06, 0x87, 0xee, 0xf6, 0xf1, 0xeb, 0x57, 0xad, 0x13, 0xbe, 0xa0, 0x03, 0x4e, 0xc7, 0xc3,
+    0xd8, 0xe8, 0x29, 0x31, 0xcc, 0x0b, 0x07, 0x63, 0x81, 0x92, 0xb7, 0x03, 0x7b, 0xb3, 0xa1, 0xbe,
+    0x25, 0xbc, 0x14, 0x9f, 0xeb, 0xb4, 0x98, 0x52, 0xa6, 0xc2, 0x09, 0xba, 0x81, 0x44, 0xff, 0xfb,
+    0xe9, 0xe1, 0x9c, 0x77, 0x3b, 0xde, 0xea, 0xdc, 0x87, 0xe9, 0x6c, 0x87, 0x33, 0x26, 0x0b, 0xdc,
+    0x74, 0xea, 0x89, 0x56, 0x63, 0x31, 0x29, 0x0c, 0x82, 0xcb, 0x10, 0x4c, 0xcd, 0xa8, 0xfb, 0x65,
+    0x30, 0x5c, 0x4c, 0x84, 0xa2, 0x3d, 0x61, 0x21, 0x65, 0x16, 0xb7, 0xd7, 0x03, 0x78, 0x38, 0x85,
+    0x91, 0x84, 0xa3, 0x93, 0x11, 0xc3, 0xa3, 0x28, 0x92, 0x9a, 0x2e, 0x25, 0xd3, 0xd6, 0x45, 0x98,
+    0x66, 0xfa, 0x83, 0x47, 0x91, 0x74, 0x60, 0x07, 0x50, 0xa5, 0x9a, 0xe3, 0xdd, 0xcd, 0xf9, 0x89,
+    0x9e, 0xe6, 0x5a, 0x11, 0xcc, 0xee, 0x92, 0x87, 0xcf, 0xc8, 0xd6, 0xd6, 0x56, 0x3b, 0x5a, 0xef,
+    0xfd, 0x41, 0xd8, 0x7b, 0x77, 0x18, 0xf6, 0xc2, 0xde, 0xfe, 0xbf, 0x06, 0x6c, 0x91, 0x3d, 0xc5,
+    0xb1, 0x50, 0x08, 0xf3, 0x8c, 0x39, 0xc8, 0x58, 0x9e, 0xa3, 0xb2, 0x34, 0x41, 0x55, 0x72, 0xb7,
+    0x68, 0x66, 0x68, 0x88, 0xb5, 0xa5, 0x60, 0xdc, 0xae, 0x3a, 0xd3, 0x55, 0x86, 0x5a, 0x91, 0x06,
+    0xf8, 0x83, 0x75, 0x24, 0x04, 0x52, 0xb2, 0x9a, 0x20, 0xe1, 0x6c, 0xd4, 0xd3, 0x16, 0x8d, 0x1f,
+    0x62, 0x0c, 0x5d, 0xef, 0x5a, 0x3a, 0xde, 0x7a, 0x47, 0x48, 0x92, 0x04, 0xde, 0x6e, 0x34, 0x7e,
+    0xea, 0xe0, 0x0f, 0x29, 0x6c, 0x69, 0x7c, 0xb0, 0xbf, 0xff, 0xac, 0x79, 0xcd, 0xeb, 0xda, 0x97,
+    0x55, 0x49, 0xe2, 0xeb, 0xed, 0xd5, 0xb7, 0x9a, 0x82, 0xc5, 0xe7, 0x7d, 0x7c, 0x9e, 0x1b, 0x2b,
+    0x22, 0xe1, 0xbd, 0xc2, 0xdc, 0x07, 0xa9, 0xd1, 0x56, 0x3b, 0x43, 0xbc, 0x77, 0xed, 0x3c, 0xae,
+    0x9d, 0x7d, 0x97, 0x73, 0x4f, 0xab, 0x52, 0x4f, 0x1d, 0x11, 0x2b, 0x19, 0xc2, 0x5c, 0xb8, 0xac,
+    0x9d, 0xdb, 0x97, 0x80, 0x3d, 0x2b, 0xe6, 0xc6, 0x95, 0xb4, 0x2c, 0x94, 0x42, 0x73, 0x36, 0xbc,
+    0xbc, 0xf0, 0x32, 0xb9, 0xad, 0x22, 0xdf, 0xd4, 0xdb, 0x47, 0xe0, 0x95, 0xd1, 0x18, 0x87, 0x53,
+    0xb4, 0x96, 0xd1, 0x3d, 0xed, 0xd0, 0xf2, 0xca, 0x86, 0x17, 0xca, 0xf1, 0x66, 0x18, 0x8f, 0x04,
+    0x9f, 0x38, 0xbc, 0x9c, 0xf1, 0x33, 0xa6, 0xb8, 0x24, 0xa2, 0xc6, 0xe8, 0xff, 0x42, 0x6b, 0xe0,
+    0x03, 0x57, 0x64, 0x96, 0x72, 0x78, 0x0e, 0x70, 0x7b, 0x79, 0x6d, 0xe9, 0x71, 0x53, 0x31, 0x5c,
+    0xe5, 0xb5, 0xf0, 0x9b, 0x3a, 0x2f, 0x6f, 0xcb, 0x17, 0x3e, 0xf5, 0xe3, 0x4c, 0xf3, 0x0d, 0x05,
+    0x40, 0x1e, 0xdd, 0x0e, 0x59, 0x74, 0x76, 0x7d, 0x95, 0xee, 0x82, 0x33, 0x05, 0x6e, 0x2c, 0xb4,
+    0xb2, 0x35, 0x3d, 0x89, 0xdd, 0x8e, 0xe5, 0x9b, 0x6d, 0xd9, 0x07, 0xd7, 0x20, 0xc7, 0xd1, 0xa2,
+    0x41, 0xc7, 0x51, 0xfd, 0x80, 0xc4, 0x23, 0xcd, 0x1f, 0x9a, 0xfe, 0x9d, 0xf5, 0xd6, 0xba, 0x3b,
+    0x2d, 0x54, 0x5b, 0xb5, 0x81, 0x64, 0x23, 0x94, 0x30, 0xd6, 0x26, 0x09, 0x16, 0x1d, 0x30, 0xe8,
+    0x0f, 0xe8, 0x35, 0x31, 0xe0, 0xdb, 0x3b, 0x38, 0x5d, 0xe3, 0xf3, 0x5f, 0xaf, 0x9e, 0xa3, 0x38,
+    0x2a, 0x9d, 0x9a, 0x23, 0xaa, 0xde, 0xeb, 0x1e, 0x72, 0x7a, 0x90, 0x1c, 0xd5, 0x40, 0x00, 0x82,
+    0x3f, 0x0d, 0x06, 0xb9, 0x64, 0x29, 0x66, 0x5a, 0x72, 0xa4, 0x43, 0x86, 0x64, 0x07, 0x56, 0xfb,
+    0xa4, 0x09, 0x35, 0x09, 0xc3, 0x30, 0x58, 0xc5, 0x33, 0x2a, 0x9c, 0xa3, 0xd7, 0x45, 0xab, 0x54,
+    0x8a, 0xf4, 0x57, 0x12, 0x2c, 0x9f, 0x99, 0xa0, 0x5f, 0xe2, 0xf0, 0x93, 0x38, 0xaa, 0xcc, 0xfa,
+    0x4d, 0x32, 0xe3, 0xec, 0xa0, 0xdf, 0x88, 0xba, 0x7a, 0x11, 0x16, 0x58, 0x69, 0xa7, 0xb6, 0xe1,
+    0x62, 0x56, 0x42, 0x6b, 0x54, 0x14, 0xf4, 0xe3, 0x88, 0xd6, 0xca, 0xdc, 0xd5, 0x39, 0x23, 0xf3,
+    0xea, 0x7d, 0xfe, 0x0b, 0x47, 0x43, 0x8e, 0x5f, 0xb1, 0x07, 0x00, 0x00,
+};
+
+/* /WEBSOCKETClient.html, WEBSOCKETClient.html, 10037 bytes, 2688 gzipped */
+static const u8 Asset_1[2688] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xc5, 0x1a, 0x69, 0x73, 0xdb, 0xb8,
+    0xf5, 0xb3, 0x32, 0x93, 0xff, 0x80, 0x30, 0xad, 0x45, 0x4d, 0x2c, 0x8a, 0xf2, 0x1d, 0x1d, 0xce,
+    0xc8, 0xb2, 0xdd, 0xf5, 0x74, 0x13, 0x67, 0xec, 0x64, 0xda, 0xce, 0x74, 0x36, 0x0b, 0x91, 0x90,
+    0xc4, 0x35, 0x45, 0xa8, 0x20, 0x68, 0xd9, 0xcd, 0xfa, 0xbf, 0xf7, 0x3d, 0x80, 0xb7, 0x48, 0x45,
+    0xce, 0xa6, 0xad, 0x32, 0xb1, 0x08, 0xe2, 0xe1, 0xdd, 0x78, 0x07, 0xa0, 0xc1, 0xab, 0xf3, 0xeb,
+    0xf1, 0xa7, 0x7f, 0x7c, 0xbc, 0x20, 0x3f, 0x7d, 0x7a, 0xff, 0xf3, 0xe9, 0xcb, 0x17, 0x83, 0xb9,
+    0x5c, 0xf8, 0xf0, 0x4d, 0x08, 0x19, 0xcc, 0x19, 0x75, 0xf5, 0x23, 0x8e, 0x42, 0xf9, 0xe8, 0xb3,
+    0x74, 0x08, 0x9f, 0x09, 0x77, 0x1f, 0xc9, 0xd7, 0xdc, 0x0b, 0xf8, 0x4c, 0x79, 0x20, 0xdb, 0x53,
+    0xba, 0xf0, 0xfc, 0xc7, 0x1e, 0x19, 0x09, 0x8f, 0xfa, 0xbb, 0x24, 0xa4, 0x41, 0xd8, 0x0e, 0x99,
+    0xf0, 0xa6, 0xfd, 0x22, 0xf0, 0x82, 0x8a, 0x99, 0x17, 0xf4, 0xc8, 0x9e, 0xbd, 0x7c, 0x28, 0x4d,
+    0x4d, 0xa8, 0x73, 0x37, 0x13, 0x3c, 0x0a, 0xdc, 0xb6, 0xc3, 0x7d, 0x2e, 0x7a, 0xe4, 0xf5, 0xf4,
+    0x00, 0xff, 0xe5, 0xe1, 0x9e, 0x5e, 0xbe, 0xc8, 0x8d, 0x5e, 0x87, 0x21, 0x2b, 0xb3, 0xa3, 0x29,
+    0xb4, 0x27, 0x5c, 0x4a, 0xbe, 0x58, 0x27, 0x54, 0x44, 0x60, 0xad, 0xd8, 0x24, 0xe4, 0xce, 0x1d,
+    0x93, 0xed, 0x49, 0x04, 0x0b, 0x82, 0x5d, 0x62, 0x39, 0x3e, 0xa3, 0x22, 0x1e, 0x96, 0x91, 0xbb,
+    0x5e, 0xb8, 0xf4, 0x29, 0xc8, 0xe9, 0x05, 0xbe, 0x17, 0xb0, 0xf6, 0xc4, 0x87, 0xc5, 0x25, 0x39,
+    0x96, 0xd4, 0x75, 0xbd, 0x60, 0xd6, 0x23, 0x5d, 0x20, 0x5d, 0x25, 0x68, 0xcc, 0xa1, 0xf0, 0x66,
+    0x73, 0xa9, 0xa1, 0xbe, 0xad, 0x89, 0x83, 0xf1, 0xe8, 0xf2, 0xd0, 0x2e, 0xc1, 0xc5, 0x93, 0xab,
+    0xb9, 0x27, 0x59, 0x19, 0x05, 0x17, 0x2e, 0x83, 0xb9, 0x80, 0x07, 0xd5, 0x53, 0x6d, 0x41, 0x5d,
+    0x2f, 0x0a, 0x7b, 0xe4, 0x70, 0x8d, 0xbc, 0x64, 0x0f, 0xb2, 0xed, 0x32, 0x87, 0x0b, 0x2a, 0x3d,
+    0x1e, 0x54, 0x22, 0x51, 0x46, 0x0f, 0xbd, 0x7f, 0x33, 0x10, 0xe0, 0x68, 0x0d, 0x83, 0x13, 0x89,
+    0x10, 0x39, 0x5b, 0x72, 0x2f, 0x90, 0x4c, 0x94, 0xf1, 0x0b, 0xf0, 0x0e, 0x4f, 0xa3, 0x2e, 0x8b,
+    0x4a, 0x6c, 0x6b, 0x3f, 0x24, 0x8c, 0x86, 0xec, 0x19, 0x46, 0xeb, 0xcd, 0xf9, 0x3d, 0x13, 0x25,
+    0xd3, 0xe9, 0x97, 0x65, 0x03, 0x56, 0xa9, 0xf6, 0x90, 0xda, 0x07, 0x6f, 0x37, 0x39, 0x19, 0x0b,
+    0xdc, 0x32, 0x9e, 0x6f, 0x1a, 0xb9, 0x82, 0x90, 0x6d, 0x9f, 0x8c, 0xcf, 0x46, 0xff, 0x1b, 0x1b,
+    0xfe, 0x3f, 0xed, 0xa3, 0x14, 0xb6, 0xb5, 0xfa, 0x6d, 0xfb, 0x78, 0x32, 0x39, 0xac, 0xc7, 0x86,
+    0xde, 0x48, 0x05, 0xa3, 0x65, 0x54, 0x2b, 0xcf, 0x95, 0x73, 0xd4, 0xbf, 0xfd, 0xe7, 0xfe, 0xc6,
+    0x08, 0x50, 0xb1, 0xc1, 0x0a, 0xd6, 0x7b, 0xae, 0x6a, 0x13, 0xb3, 0x74, 0xc1, 0xf0, 0x21, 0xf7,
+    0x3d, 0x97, 0xbc, 0x76, 0x1c, 0x67, 0x7b, 0xfd, 0x97, 0x95, 0x25, 0xa9, 0x8c, 0xc2, 0xca, 0xa0,
+    0xba, 0x62, 0x3a, 0x44, 0x4c, 0xb8, 0xef, 0xf6, 0xff, 0x48, 0x94, 0xdb, 0x14, 0xd2, 0x2a, 0xc3,
+    0xee, 0xc1, 0xfe, 0xfe, 0xd1, 0x96, 0xf8, 0xb6, 0x36, 0xb4, 0xbb, 0xbf, 0x37, 0xdd, 0x9b, 0x96,
+    0xb0, 0xc6, 0x89, 0xa6, 0x93, 0x64, 0x9a, 0x2c, 0xf5, 0x38, 0xc2, 0x5b, 0x4a, 0x22, 0x1f, 0x97,
+    0x6c, 0x68, 0xa0, 0x0f, 0x74, 0x7e, 0xa3, 0xf7, 0x54, 0xbf, 0x35, 0x00, 0xb0, 0xd1, 0xc0, 0xff,
+    0x9d, 0x0e, 0xf9, 0x0c, 0x29, 0x00, 0x36, 0x08, 0xe1, 0x53, 0x22, 0xe7, 0x0c, 0x14, 0xe7, 0xfb,
+    0x7c, 0x05, 0xc6, 0x25, 0x92, 0xc3, 0xe6, 0x5a, 0x2c, 0x23, 0xc9, 0xc8, 0xf8, 0x66, 0xdc, 0xee,
+    0x1e, 0x11, 0xf3, 0x3d, 0x77, 0x27, 0x51, 0xd8, 0x8a, 0x57, 0x8e, 0x5c, 0x57, 0x2d, 0x81, 0x59,
+    0x04, 0xc6, 0xc7, 0x05, 0x0b, 0x43, 0x3a, 0x63, 0x6a, 0xc8, 0x42, 0xa9, 0xde, 0x79, 0x8b, 0xa5,
+    0xcf, 0x16, 0x2c, 0x90, 0x2a, 0x1a, 0xc6, 0x6b, 0xe7, 0x52, 0x2e, 0xc3, 0x5e, 0xa7, 0xb3, 0x5a,
+    0xad, 0x2c, 0x9f, 0x2e, 0x16, 0x4c, 0xc8, 0x89, 0xc7, 0x42, 0x2b, 0xf0, 0x3b, 0x40, 0x74, 0xd1,
+    0xf1, 0x82, 0x29, 0xef, 0x38, 0xc2, 0x69, 0x3b, 0xd4, 0x77, 0x22, 0xbf, 0x6e, 0xa9, 0xa4, 0x73,
+    0xba, 0xa4, 0x77, 0x61, 0x64, 0xc1, 0x2a, 0x84, 0xef, 0x94, 0x80, 0xe0, 0x15, 0x62, 0x50, 0xd3,
+    0xef, 0x60, 0x30, 0x1c, 0x8d, 0xce, 0xce, 0xc6, 0xe3, 0xf3, 0xf3, 0x8b, 0x8b, 0xcb, 0xcb, 0xee,
+    0xde, 0xfe, 0xc1, 0xe1, 0xd1, 0xf1, 0xc9, 0xdb, 0x9d, 0x05, 0x93, 0x73, 0xee, 0x0e, 0xb5, 0x9c,
+    0x9d, 0xf7, 0xd7, 0xe7, 0x67, 0x9f, 0x6f, 0x77, 0x5c, 0x0a, 0x2c, 0xa3, 0xfe, 0xec, 0x1d, 0x0e,
+    0xa6, 0x52, 0x4f, 0x39, 0xc5, 0x5d, 0x47, 0x12, 0x94, 0x03, 0x0a, 0x13, 0x64, 0x74, 0x3b, 0xbe,
+    0xba, 0x22, 0xa1, 0x14, 0xa8, 0xb7, 0x4a, 0x0a, 0xf1, 0x9a, 0x1b, 0x16, 0x46, 0xbe, 0x6c, 0x8c,
+    0xe7, 0xcc, 0xb9, 0x6b, 0x7c, 0xe4, 0xfe, 0x63, 0xe3, 0x2a, 0xf0, 0x64, 0xe3, 0x86, 0x4d, 0xaf,
+    0x02, 0xfc, 0x0b, 0x38, 0x1b, 0x7f, 0xe7, 0x02, 0xbe, 0xe2, 0x05, 0xf6, 0xc3, 0xdb, 0xa3, 0xe3,
+    0xc3, 0x86, 0xfd, 0x70, 0x70, 0xb6, 0x7f, 0x0c, 0x5f, 0x27, 0xb6, 0x8d, 0xa3, 0x4b, 0xf8, 0x34,
+    0xa4, 0x88, 0x98, 0xfe, 0x63, 0x3f, 0xd8, 0xf0, 0x41, 0xeb, 0x37, 0x1a, 0xd3, 0x28, 0x70, 0x50,
+    0x5b, 0x04, 0xa4, 0xed, 0x1e, 0x7d, 0x5e, 0x82, 0x14, 0xcc, 0x84, 0xe7, 0x5d, 0x32, 0x79, 0x94,
+    0xac, 0x85, 0x8e, 0xd6, 0x00, 0x28, 0xe0, 0xda, 0xf4, 0x99, 0x24, 0x1e, 0x19, 0x12, 0xbb, 0x0f,
+    0x5f, 0x03, 0x72, 0x02, 0x5f, 0x6f, 0xde, 0x24, 0x10, 0x0d, 0x6f, 0x4a, 0x4c, 0x5c, 0x48, 0x7e,
+    0x89, 0x57, 0xee, 0x90, 0x6e, 0x3a, 0xd9, 0xc0, 0x89, 0x21, 0x51, 0xf3, 0xa7, 0xa7, 0x38, 0xf1,
+    0x0b, 0xf0, 0x3a, 0xb2, 0xed, 0x6e, 0x5f, 0x03, 0x3c, 0x11, 0xe6, 0xeb, 0xe2, 0x22, 0x05, 0x3f,
+    0x3d, 0x1d, 0x92, 0x74, 0x5a, 0x7f, 0x21, 0xe2, 0xfc, 0x7b, 0xfd, 0x5a, 0x30, 0x19, 0x09, 0x25,
+    0x00, 0xd0, 0xd4, 0xc2, 0xaa, 0xe9, 0xa7, 0x2a, 0x09, 0x2f, 0xb9, 0xb8, 0x55, 0x8a, 0x37, 0x41,
+    0xff, 0x09, 0x7f, 0x28, 0x99, 0xe6, 0x30, 0x5e, 0x4e, 0x40, 0x97, 0xa8, 0x6a, 0xa8, 0xae, 0x20,
+    0xa8, 0x28, 0x97, 0xbd, 0xa7, 0x7e, 0xc4, 0x34, 0xc6, 0x4a, 0x75, 0x00, 0x3a, 0xcb, 0x67, 0xc1,
+    0x4c, 0xce, 0x8b, 0x7a, 0x41, 0x30, 0xc5, 0xf7, 0x50, 0x81, 0x38, 0x73, 0x2a, 0xc6, 0xdc, 0x65,
+    0x23, 0x69, 0x7a, 0xad, 0x98, 0x5f, 0x45, 0xee, 0x2f, 0x4c, 0xfb, 0xbf, 0x82, 0x55, 0xc4, 0x92,
+    0x3d, 0x86, 0x4b, 0xa8, 0x03, 0x89, 0x43, 0x23, 0xd4, 0x8c, 0x56, 0x9b, 0x2b, 0x55, 0x4b, 0x49,
+    0x31, 0x5a, 0x1f, 0x8d, 0xc4, 0x1d, 0x53, 0x95, 0x48, 0xfe, 0x13, 0x7b, 0x40, 0x46, 0x34, 0xb3,
+    0x68, 0x43, 0x94, 0xc5, 0x26, 0xbf, 0xff, 0x0e, 0x42, 0x81, 0xa1, 0x0e, 0x53, 0x39, 0xe4, 0x5c,
+    0xf0, 0x15, 0x09, 0xd8, 0x8a, 0x5c, 0x08, 0xc1, 0x85, 0x69, 0x5c, 0x05, 0xe8, 0xcf, 0x8b, 0x08,
+    0xf6, 0xed, 0x04, 0xd8, 0x66, 0x72, 0xc5, 0x58, 0x00, 0x4b, 0x29, 0xa4, 0xef, 0xee, 0xa1, 0xd1,
+    0xaa, 0x30, 0x11, 0xe0, 0x1e, 0x92, 0xb7, 0xe4, 0x1d, 0xd1, 0x26, 0xb0, 0xa6, 0x82, 0x2f, 0xc6,
+    0xb1, 0x42, 0xcc, 0xa6, 0xdd, 0xcc, 0x6b, 0xc7, 0x6e, 0x91, 0x37, 0x04, 0x38, 0xeb, 0x55, 0x03,
+    0x8f, 0xca, 0xc0, 0x6d, 0xc8, 0x2e, 0x6a, 0x45, 0x62, 0x7b, 0x64, 0x5a, 0x0b, 0x9c, 0x04, 0xc0,
+    0x7b, 0x2a, 0xc8, 0xdf, 0xd8, 0xe4, 0x56, 0x15, 0x33, 0x63, 0xdf, 0x83, 0x20, 0x83, 0x4e, 0x99,
+    0x6a, 0xc3, 0x6c, 0x95, 0xe3, 0x2a, 0xae, 0x60, 0x0f, 0x4b, 0x2e, 0x64, 0x08, 0x90, 0x5f, 0x9f,
+    0xfa, 0xeb, 0xd3, 0x5e, 0xf8, 0xc5, 0xe1, 0x41, 0xc0, 0xc0, 0x40, 0x2e, 0xc0, 0x4c, 0xa9, 0x1f,
+    0xb2, 0x0a, 0xb0, 0x15, 0x22, 0x08, 0x22, 0xdf, 0xef, 0x17, 0x62, 0x3b, 0x7c, 0x62, 0xfc, 0x96,
+    0x07, 0xfe, 0x86, 0x08, 0x62, 0x6e, 0xcc, 0x48, 0xf8, 0x6b, 0xfc, 0xe0, 0x07, 0x7c, 0x45, 0x05,
+    0x04, 0x02, 0xd6, 0xa2, 0x99, 0x3c, 0x24, 0xe6, 0x02, 0x05, 0xf1, 0x42, 0x42, 0x7d, 0x48, 0xe2,
+    0xd0, 0x3d, 0xf0, 0x25, 0x0b, 0xd6, 0x71, 0x28, 0x43, 0xe7, 0x18, 0xaf, 0x24, 0xa4, 0xeb, 0xa5,
+    0x00, 0x92, 0x2e, 0xb3, 0x7c, 0x3e, 0x33, 0x8d, 0x8c, 0x56, 0x8e, 0x40, 0x8a, 0xc3, 0x52, 0x26,
+    0xaf, 0x42, 0xa2, 0xad, 0xaf, 0xbc, 0xfc, 0xe2, 0x01, 0x84, 0x54, 0x8c, 0x3f, 0x87, 0xdd, 0xa7,
+    0xb2, 0xce, 0x12, 0x19, 0x5e, 0xe5, 0x98, 0x32, 0xa0, 0x4b, 0x80, 0x32, 0x25, 0x70, 0xf9, 0xaa,
+    0x55, 0x2b, 0x8f, 0xf6, 0xe2, 0x9c, 0x24, 0x1f, 0xae, 0x3f, 0x91, 0x30, 0x5a, 0xa2, 0x09, 0xc0,
+    0x7e, 0x93, 0x47, 0xf2, 0xc8, 0x23, 0x41, 0xce, 0x00, 0x0a, 0xfa, 0xa9, 0x57, 0x46, 0x7f, 0x4b,
+    0x66, 0xb4, 0x79, 0x61, 0x73, 0xa4, 0x98, 0x95, 0xfd, 0xfa, 0x55, 0x90, 0x16, 0x0f, 0x50, 0xcc,
+    0xbc, 0xad, 0x6b, 0xf9, 0x2d, 0x79, 0x17, 0x86, 0xef, 0x1a, 0x25, 0xbb, 0xdc, 0x89, 0x30, 0x6d,
+    0x5a, 0x33, 0x26, 0x2f, 0x74, 0x06, 0x3d, 0x7b, 0xbc, 0x72, 0x4d, 0x43, 0x57, 0x3c, 0x46, 0xcb,
+    0xc2, 0xb4, 0x3e, 0x86, 0x42, 0x47, 0xbb, 0xbd, 0x31, 0x4e, 0xf0, 0x1a, 0xdf, 0x8d, 0x51, 0x95,
+    0x11, 0x96, 0xae, 0x54, 0x01, 0xe3, 0x4c, 0x40, 0x04, 0xa8, 0xc3, 0x56, 0xe3, 0x49, 0x39, 0x37,
+    0x40, 0xa5, 0x24, 0x6e, 0x54, 0xa3, 0x8d, 0xa9, 0x99, 0xec, 0x16, 0x1e, 0x5c, 0x03, 0x78, 0xad,
+    0xde, 0x72, 0xfb, 0x4a, 0x43, 0x9a, 0x75, 0xce, 0xf9, 0x54, 0x61, 0xe1, 0x7e, 0xb5, 0x89, 0x01,
+    0x55, 0x52, 0xb1, 0x64, 0xb6, 0x23, 0x26, 0xbb, 0x97, 0x69, 0x94, 0x44, 0x40, 0x8c, 0xf8, 0x82,
+    0x39, 0xcc, 0xbb, 0x67, 0xee, 0x17, 0xac, 0x0a, 0x00, 0x1a, 0x60, 0x2c, 0x7c, 0xec, 0x67, 0x60,
+    0x05, 0x85, 0x0c, 0xb7, 0xff, 0xd4, 0x6e, 0xb3, 0x02, 0xc2, 0x9b, 0x98, 0x01, 0x82, 0x54, 0x7b,
+    0xc6, 0x6e, 0x91, 0xa3, 0x3a, 0x14, 0xc8, 0x3a, 0xce, 0x7f, 0xf1, 0x95, 0x7f, 0x16, 0xd6, 0x24,
+    0xd9, 0x6d, 0x0b, 0xe2, 0xe7, 0x28, 0x34, 0x80, 0xf7, 0xd4, 0x14, 0x10, 0x4f, 0x70, 0xd6, 0xd1,
+    0xc5, 0xbd, 0x9c, 0xd2, 0x1d, 0x90, 0x83, 0x4d, 0x76, 0x4d, 0x49, 0x31, 0x9d, 0x87, 0x0a, 0x92,
+    0x62, 0x2c, 0x91, 0x9c, 0x93, 0x70, 0x0e, 0xb6, 0xd7, 0x35, 0x29, 0x54, 0x92, 0x10, 0x18, 0x28,
+    0x26, 0xf1, 0xfa, 0x10, 0x95, 0x0b, 0x53, 0xb5, 0x6e, 0x52, 0xaf, 0xb2, 0xd8, 0x2b, 0x6e, 0x3d,
+    0x97, 0xad, 0x69, 0x2d, 0xf4, 0x3d, 0x87, 0x99, 0xf6, 0x2e, 0x69, 0x1f, 0x6c, 0xd2, 0x3a, 0x70,
+    0xb7, 0x61, 0x79, 0xfd, 0xda, 0x2d, 0xac, 0xf1, 0x3e, 0xf6, 0x59, 0xc4, 0xdf, 0x43, 0x6b, 0xe4,
+    0xd8, 0xdd, 0xca, 0x97, 0xb0, 0xfc, 0xd1, 0x8b, 0x63, 0x73, 0xc6, 0xcc, 0xd6, 0x6f, 0x54, 0x55,
+    0x50, 0xe9, 0x6e, 0xc0, 0xc5, 0xd5, 0xc3, 0x72, 0xf1, 0x55, 0x62, 0xa1, 0x8e, 0x89, 0x02, 0x86,
+    0x6c, 0x64, 0x49, 0x1e, 0xe3, 0xe9, 0x1e, 0x41, 0x5c, 0xe3, 0x9f, 0x97, 0x4b, 0x26, 0xc6, 0xd0,
+    0x25, 0x9b, 0xad, 0x7a, 0x5c, 0x99, 0x40, 0xcd, 0x71, 0x8c, 0x0a, 0x05, 0xe9, 0x91, 0xe6, 0x6e,
+    0x1e, 0x77, 0xab, 0x5f, 0xe3, 0x1e, 0x71, 0x69, 0xfa, 0xf2, 0x45, 0xa7, 0x33, 0xda, 0xdf, 0x1b,
+    0x5d, 0x1e, 0x1e, 0x5c, 0x42, 0xe5, 0x7e, 0x74, 0x7c, 0x3c, 0x3e, 0xbf, 0xbc, 0xb8, 0x18, 0xd9,
+    0xa3, 0x63, 0x3b, 0x05, 0x51, 0x5f, 0x98, 0xa8, 0x79, 0x00, 0xdd, 0x9a, 0x24, 0x73, 0xf6, 0x40,
+    0x5d, 0xe6, 0x78, 0x0b, 0xea, 0xc7, 0x75, 0x3f, 0xba, 0x29, 0xc1, 0xe3, 0x80, 0x19, 0x13, 0x61,
+    0xbc, 0x40, 0x55, 0x94, 0x81, 0xfc, 0x52, 0x94, 0x7b, 0x49, 0x45, 0xc8, 0xae, 0x02, 0x69, 0xe6,
+    0x5e, 0xef, 0x42, 0x9b, 0x1b, 0x17, 0x58, 0xd9, 0xb2, 0xcc, 0x85, 0xd2, 0x25, 0xf1, 0xab, 0x04,
+    0x3c, 0x63, 0x4c, 0xd5, 0x70, 0x64, 0xea, 0xd3, 0x19, 0xf1, 0x92, 0x3a, 0x37, 0x3e, 0x7e, 0xc2,
+    0x1c, 0x83, 0x1b, 0x12, 0x4b, 0x4f, 0xb9, 0xe2, 0x59, 0xf1, 0x0b, 0x59, 0x5a, 0x30, 0xc2, 0xfe,
+    0x15, 0x51, 0x3f, 0x47, 0x59, 0xed, 0xc2, 0x4b, 0x44, 0x04, 0xa5, 0xd4, 0x1a, 0xf7, 0xc3, 0x61,
+    0x9e, 0xb5, 0x22, 0x0f, 0x3f, 0xf3, 0x99, 0x22, 0xc2, 0x32, 0x5e, 0xb0, 0xb0, 0x76, 0xd9, 0x24,
+    0x9a, 0x41, 0xb7, 0x3d, 0x4b, 0x7a, 0x81, 0xbc, 0x2b, 0xe6, 0xa9, 0x81, 0x23, 0xa6, 0xc3, 0x22,
+    0xe6, 0x73, 0x7d, 0x6e, 0x98, 0xf6, 0x97, 0x58, 0x92, 0x22, 0x3b, 0xc8, 0x1a, 0x15, 0x5e, 0x08,
+    0x51, 0x5b, 0xa8, 0xd6, 0x2a, 0x27, 0x07, 0x38, 0xe8, 0xad, 0x3e, 0x1b, 0x18, 0xe6, 0x64, 0x7a,
+    0x47, 0xd0, 0xfb, 0xdb, 0xd7, 0x7f, 0x35, 0xa0, 0x10, 0x55, 0x8f, 0x17, 0x37, 0x37, 0xd7, 0x37,
+    0x46, 0xa2, 0xfb, 0xda, 0x1c, 0x89, 0xcd, 0x68, 0x4d, 0xe6, 0xfd, 0x55, 0xed, 0x27, 0x35, 0xd7,
+    0x23, 0x7f, 0xfa, 0x9a, 0x12, 0x7e, 0xfa, 0xf5, 0x79, 0x58, 0x8b, 0xd9, 0xb7, 0xc0, 0xb3, 0xce,
+    0xc4, 0xc8, 0xb2, 0xd0, 0xf9, 0x3d, 0x46, 0x8c, 0x71, 0x36, 0xd3, 0xd9, 0x36, 0x41, 0x36, 0x0d,
+    0x00, 0xe0, 0x02, 0x9e, 0xab, 0x5c, 0x04, 0xea, 0x25, 0xc7, 0x01, 0xcd, 0x4e, 0x23, 0xbf, 0x3e,
+    0xa0, 0x66, 0x0d, 0xdd, 0xf7, 0x50, 0x98, 0x52, 0xcf, 0xdf, 0x54, 0x51, 0x3e, 0x6d, 0x55, 0x21,
+    0xc4, 0x81, 0x6f, 0xa3, 0x9c, 0x6b, 0xd0, 0x66, 0x92, 0xaa, 0x7f, 0x4c, 0xc1, 0xa0, 0x9d, 0xbb,
+    0x50, 0x2e, 0x08, 0xb1, 0x6d, 0xb9, 0x57, 0xd5, 0x4c, 0x7c, 0x77, 0xbd, 0xa7, 0xb6, 0xfc, 0x0f,
+    0xab, 0xf5, 0x44, 0x7d, 0xdd, 0x58, 0xca, 0xcf, 0x59, 0xad, 0xa7, 0x5e, 0xf4, 0xe2, 0x7d, 0x5b,
+    0xa7, 0x5e, 0xd0, 0x9a, 0xe3, 0x73, 0x0c, 0xe5, 0xfd, 0x67, 0x29, 0x5a, 0x2d, 0xfa, 0x9e, 0x9a,
+    0xfa, 0x87, 0x2a, 0x19, 0x22, 0x8f, 0xf3, 0xc3, 0xeb, 0xea, 0x2d, 0x74, 0xad, 0x37, 0x51, 0xa1,
+    0xa5, 0x52, 0x0a, 0x71, 0x2d, 0xab, 0x7a, 0x17, 0x95, 0x5b, 0xd9, 0xa7, 0xba, 0xb6, 0x74, 0x3b,
+    0xbd, 0x62, 0x60, 0x81, 0x1e, 0x68, 0x67, 0x07, 0x8d, 0xa1, 0x5a, 0x39, 0x8c, 0x69, 0x4c, 0x25,
+    0x80, 0xd4, 0x01, 0xac, 0xeb, 0x8f, 0x17, 0x1f, 0x6a, 0xcd, 0xb2, 0xd1, 0xf0, 0xcf, 0xb4, 0xdb,
+    0x77, 0xab, 0x45, 0x15, 0x2f, 0xdc, 0x51, 0x51, 0x08, 0xe4, 0xf0, 0x39, 0x75, 0x81, 0x1f, 0xa2,
+    0xce, 0xe2, 0x70, 0xa0, 0x12, 0xd6, 0x8a, 0x4d, 0x96, 0x2a, 0xad, 0x4c, 0x25, 0x13, 0x0a, 0xa1,
+    0x3a, 0x00, 0x85, 0x99, 0x54, 0xd4, 0x0a, 0x85, 0x6f, 0x0c, 0x88, 0xf5, 0x7d, 0x76, 0xc0, 0xa5,
+    0xea, 0x8c, 0xa0, 0x48, 0xa1, 0x01, 0x0e, 0x94, 0x00, 0x3f, 0x80, 0xfb, 0x38, 0xc5, 0x67, 0xc4,
+    0x56, 0x34, 0xa3, 0x56, 0xd9, 0xf6, 0x6e, 0x18, 0x56, 0xfb, 0x0e, 0xde, 0x4c, 0xbc, 0xaf, 0xe8,
+    0x98, 0x16, 0xe1, 0xac, 0xd6, 0x8b, 0xb6, 0x3a, 0x96, 0x58, 0x69, 0xdc, 0x0a, 0x51, 0xff, 0xb9,
+    0xba, 0xa6, 0x3e, 0x94, 0x64, 0xa6, 0xf1, 0x81, 0xcb, 0xec, 0xf0, 0xe2, 0x55, 0xf5, 0x26, 0x29,
+    0xc9, 0x5c, 0x7f, 0x76, 0x13, 0x8e, 0xf3, 0x9e, 0xb9, 0x71, 0xab, 0x24, 0x67, 0x61, 0x39, 0x39,
+    0xfb, 0xdb, 0xd2, 0x49, 0xb3, 0x54, 0x76, 0x98, 0x54, 0xdf, 0xf2, 0x56, 0xc3, 0x14, 0x47, 0x31,
+    0x33, 0xf1, 0xc2, 0x1c, 0xe8, 0x93, 0xd9, 0x2a, 0x16, 0xe6, 0xf9, 0x63, 0xa7, 0x94, 0xf1, 0x6c,
+    0x3a, 0xef, 0xc0, 0xa5, 0x33, 0xb6, 0xbc, 0x76, 0xca, 0x58, 0xcb, 0xa0, 0x29, 0xe7, 0xf5, 0x3a,
+    0xc4, 0x62, 0x6d, 0xaa, 0x2b, 0xc0, 0x3c, 0x50, 0x55, 0x2b, 0x84, 0xfe, 0xb4, 0x99, 0x19, 0x5c,
+    0xb7, 0x5d, 0x4b, 0x55, 0xc6, 0x93, 0xf3, 0x6d, 0xb3, 0x59, 0xd5, 0x10, 0x34, 0x2b, 0x3b, 0x89,
+    0xad, 0x9c, 0xac, 0x91, 0x3f, 0xb5, 0x4c, 0x64, 0x56, 0x77, 0x87, 0x50, 0x23, 0x5d, 0x9d, 0xe3,
+    0x51, 0x32, 0x93, 0x57, 0xf1, 0xd8, 0x44, 0x65, 0xec, 0x92, 0x3d, 0xdb, 0xb6, 0xd7, 0x5b, 0xa9,
+    0x75, 0xfd, 0x8e, 0xb7, 0x8a, 0xe7, 0x9d, 0x8e, 0xba, 0x74, 0x4a, 0x69, 0x64, 0xc4, 0xab, 0xf6,
+    0x49, 0x21, 0x7a, 0x25, 0x6b, 0x88, 0xc2, 0xc0, 0xdc, 0xdd, 0xfc, 0x19, 0xa5, 0x0e, 0xbe, 0x6b,
+    0x9b, 0x2d, 0x9f, 0x8d, 0xb2, 0xe7, 0x41, 0x47, 0x5f, 0x40, 0xc5, 0x3f, 0x96, 0xe8, 0x64, 0xbf,
+    0x96, 0x18, 0xe0, 0x2f, 0x23, 0xb2, 0x1f, 0x4e, 0xb8, 0xde, 0x3d, 0xf1, 0xdc, 0x61, 0x92, 0x40,
+    0x4f, 0xf3, 0x59, 0x78, 0xd0, 0x81, 0xd9, 0x75, 0xd0, 0x5c, 0x25, 0x7d, 0x9a, 0xaf, 0xc7, 0x31,
+    0x2a, 0x28, 0x3f, 0xcf, 0x56, 0x36, 0x32, 0xab, 0x65, 0x94, 0x42, 0x66, 0xe4, 0x7f, 0xa9, 0x31,
+    0xa0, 0x64, 0x2e, 0xd8, 0x74, 0x68, 0x64, 0xd7, 0x66, 0xbd, 0x35, 0xcf, 0x83, 0x46, 0xcb, 0x6c,
+    0xae, 0xf0, 0x9e, 0xa9, 0xfb, 0x76, 0xcf, 0xea, 0x1e, 0x9d, 0x58, 0x5d, 0xab, 0x6b, 0xf7, 0x4e,
+    0xec, 0x93, 0x93, 0x0e, 0x73, 0xe6, 0xbc, 0xd9, 0x32, 0x40, 0x43, 0x34, 0x0c, 0x87, 0x46, 0xf9,
+    0xce, 0xdd, 0x38, 0xbd, 0x89, 0x82, 0x4c, 0x91, 0x83, 0x0e, 0x7d, 0x2e, 0xf5, 0x38, 0xb7, 0x6e,
+    0xa0, 0xa0, 0x3d, 0xa3, 0x92, 0x46, 0x51, 0x89, 0x79, 0x6d, 0x14, 0xd8, 0x48, 0x2f, 0x8f, 0x51,
+    0x45, 0xea, 0x77, 0x0d, 0x28, 0x96, 0x41, 0xf0, 0x34, 0x75, 0x68, 0x74, 0x6d, 0x03, 0xef, 0xdf,
+    0xe1, 0xe9, 0x00, 0x9e, 0xb0, 0x48, 0xe0, 0x81, 0xff, 0x78, 0x3a, 0xe8, 0x24, 0xcb, 0x0a, 0xb8,
+    0xe2, 0xeb, 0xd3, 0x98, 0xdb, 0xfc, 0x15, 0xa8, 0x41, 0xb0, 0xda, 0xf3, 0x9c, 0xbb, 0xa1, 0x51,
+    0x57, 0x4a, 0x35, 0x53, 0xe2, 0xcd, 0x96, 0xa5, 0x2f, 0x53, 0x86, 0xa4, 0xd9, 0xec, 0xa3, 0x90,
+    0x80, 0x88, 0x24, 0x67, 0x46, 0x83, 0x8e, 0x46, 0xf9, 0x87, 0x05, 0xad, 0x94, 0xf1, 0xbf, 0x27,
+    0x5a, 0xb5, 0x54, 0xea, 0x46, 0x66, 0x5b, 0x91, 0x62, 0x26, 0x94, 0x33, 0x43, 0x28, 0x33, 0x74,
+    0x8f, 0x1f, 0x0f, 0x4e, 0x6f, 0xe1, 0xef, 0x1a, 0xa6, 0xad, 0x6f, 0x8b, 0x37, 0x47, 0xa0, 0xf5,
+    0x8a, 0xa0, 0xb6, 0x20, 0x80, 0x30, 0x54, 0x75, 0x92, 0x05, 0x65, 0x51, 0x72, 0x4a, 0x86, 0x47,
+    0x9b, 0x35, 0x55, 0x40, 0x6d, 0x9d, 0x9d, 0x79, 0x66, 0xa2, 0xc6, 0x37, 0x50, 0x65, 0xff, 0x13,
+    0xb4, 0xff, 0x06, 0x71, 0x7d, 0xab, 0x32, 0xae, 0xaf, 0xdf, 0x51, 0x75, 0x2d, 0x2b, 0x36, 0xe1,
+    0x37, 0x63, 0x2c, 0x5e, 0x0b, 0x21, 0x2b, 0x00, 0xb8, 0x91, 0xd5, 0x84, 0xcb, 0x7e, 0x55, 0x82,
+    0x33, 0x11, 0x22, 0x3e, 0x9a, 0x25, 0xa7, 0xc4, 0xde, 0xee, 0x26, 0x27, 0xb7, 0x48, 0xf5, 0x63,
+    0xb9, 0x71, 0x5d, 0x5d, 0xb9, 0x29, 0xff, 0xe1, 0xf2, 0x2d, 0xeb, 0xa7, 0xea, 0xc8, 0x1e, 0x87,
+    0x73, 0x08, 0xf1, 0xfa, 0xb7, 0x71, 0xff, 0x01, 0x74, 0x8a, 0x1d, 0x6e, 0x35, 0x27, 0x00, 0x00,
+};
+
+const st_http_asset HTTP_Assets[] = {
+    /* Hash of path   Path   Gzip   Headers   ETag   Length of headers   Body   Length */
+    { 0xc6b04a32u, "/AJAXClient.html", 1, "Content-Type: text/html; charset=utf-8\r\nContent-Encoding: gzip\r\nContent-Length: 812\r\nETag: \"5f8e4347\"\r\nCache-Control: no-cache\r\n\r\n", "\"5f8e4347\"", 130, Asset_0, sizeof(Asset_0) },
+    { 0xf806cd69u, "/WEBSOCKETClient.html", 1, "Content-Type: text/html; charset=utf-8\r\nContent-Encoding: gzip\r\nContent-Length: 2688\r\nETag: \"6e1d8a74\"\r\nCache-Control: no-cache\r\n\r\n", "\"6e1d8a74\"", 131, Asset_1, sizeof(Asset_1) },
+};
+
+const u8 HTTP_ASSET_NUM = sizeof(HTTP_Assets) / sizeof(HTTP_Assets[0]);
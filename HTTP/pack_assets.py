@@ -0,0 +1,110 @@
+# Packs the web pages into HTTP/WebAssets.c, served by the HTTP server from flash.
+#
+#   python HTTP/pack_assets.py                   the default pages below
+#   python HTTP/pack_assets.py /path=file ...    other ones
+#
+# Each body is gzipped when that makes it smaller, and its headers (Content-Type,
+# Content-Encoding, Content-Length, ETag) and the FNV-1a hash of its path are
+# computed here, so the firmware only looks the path up and sends.
+# Run it again after changing a page, WebAssets.c is not edited by hand.
+
+import gzip
+import os
+import sys
+import zlib
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUT = os.path.join(ROOT, 'HTTP', 'WebAssets.c')
+
+ASSETS = [
+    ('/AJAXClient.html', 'AJAXClient.html'),
+    ('/WEBSOCKETClient.html', 'WEBSOCKETClient.html'),
+]
+
+TYPES = {
+    '.html': 'text/html; charset=utf-8',
+    '.js': 'application/javascript',
+    '.css': 'text/css',
+    '.json': 'application/json',
+    '.svg': 'image/svg+xml',
+    '.png': 'image/png',
+    '.ico': 'image/x-icon',
+}
+
+MAX_URL_SIZE = 32           # HTTPS.h
+HTTP_ASSET_HEAD_LEN = 192   # HTTPS.h
+
+
+def fnv1a(path):
+    h = 2166136261
+    for ch in path.encode():
+        h = ((h ^ ch) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def c_string(s):
+    return '"' + s.replace('\\', '\\\\').replace('"', '\\"').replace('\r', '\\r').replace('\n', '\\n') + '"'
+
+
+def pack(path, name):
+    data = open(os.path.join(ROOT, name), 'rb').read()
+    body = gzip.compress(data, 9, mtime=0)      # mtime 0: the same output for the same page
+    zipped = len(body) < len(data)
+    if not zipped:
+        body = data
+    head = 'Content-Type: %s\r\n' % TYPES.get(os.path.splitext(name)[1].lower(), 'application/octet-stream')
+    if zipped:
+        head += 'Content-Encoding: gzip\r\n'
+    head += 'Content-Length: %u\r\n' % len(body)
+    etag = '"%08x"' % zlib.crc32(data)
+    head += 'ETag: %s\r\n' % etag
+    head += 'Cache-Control: no-cache\r\n\r\n'       # Asked again each time, with If-None-Match
+    return data, body, zipped, head, etag
+
+
+def main(args):
+    assets = [tuple(a.split('=', 1)) for a in args] if args else ASSETS
+    out = []
+    table = []
+    for i, (path, name) in enumerate(assets):
+        if not path.startswith('/') or len(path) >= MAX_URL_SIZE:
+            sys.exit('%s: the path must start with / and be shorter than %u' % (path, MAX_URL_SIZE))
+        data, body, zipped, head, etag = pack(path, name)
+        if len(head) > HTTP_ASSET_HEAD_LEN:
+            sys.exit('%s: %u bytes of headers, HTTP_ASSET_HEAD_LEN is %u' % (path, len(head), HTTP_ASSET_HEAD_LEN))
+        var = 'Asset_%u' % i
+        out.append('/* %s, %s, %u bytes%s */' % (path, name, len(data),
+                   ', %u gzipped' % len(body) if zipped else ''))
+        out.append('static const u8 %s[%u] = {' % (var, len(body)))
+        for j in range(0, len(body), 16):
+            out.append('    ' + ', '.join('0x%02x' % b for b in body[j:j + 16]) + ',')
+        out.append('};')
+        out.append('')
+        table.append('    { 0x%08xu, %s, %u, %s, %s, %u, %s, sizeof(%s) },' % (fnv1a(path), c_string(path), zipped,
+                     c_string(head), c_string(etag), len(head), var, var))
+        print('%-24s %6u -> %6u bytes' % (path, len(data), len(body)))
+
+    text = [
+        '/****************************** (C) COPYRIGHT ***********************************',
+        ' * File Name : WebAssets.c',
+        ' * Description : Web pages served from flash, generated by HTTP/pack_assets.py,',
+        ' *               do not edit.',
+        '*********************************************************************************/',
+        '#include "HTTPS.h"',
+        '',
+    ] + out + [
+        'const st_http_asset HTTP_Assets[] = {',
+        '    /* Hash of path   Path   Gzip   Headers   ETag   Length of headers   Body   Length */',
+    ] + table + [
+        '};',
+        '',
+        'const u8 HTTP_ASSET_NUM = sizeof(HTTP_Assets) / sizeof(HTTP_Assets[0]);',
+        '',
+    ]
+    # The sources use CRLF
+    with open(OUT, 'wb') as f:
+        f.write('\r\n'.join(text).encode())
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
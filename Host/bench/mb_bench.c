@@ -0,0 +1,541 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : mb_bench.c
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Modbus TCP throughput and latency benchmark.
+*********************************************************************************/
+
+/*
+    Two builds of the same driver (see Host/Makefile, "make bench"):
+
+      mb_bench         - Modbus TCP client, runs against the board or the host
+                         build (ch32v307_host) and measures round trip latency.
+                         With -r the requests are sent on a fixed schedule and
+                         latency is taken from the scheduled send time, so a
+                         slow server is not hidden by the client waiting on it.
+
+      mb_bench_inproc  - links Modbus/ModbusTCP.c directly and calls
+                         MB_TCP_Receive in a loop, the WCHNET socket calls only
+                         copy the request/reply. Measures the handler cost alone.
+
+    Mix syntax: fc:weight[:quantity],... e.g. "1:30:64,3:30:40,5:10,16:10:10"
+    Supported function codes: 1, 3, 5, 6, 15, 16.
+
+    Bytes on the wire are the Modbus ADU bytes (MBAP + PDU) plus an estimate of
+    the Ethernet/IP/TCP framing, one segment per request and per reply.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+
+#ifdef MB_BENCH_INPROC
+#include <fcntl.h>
+#include "debug.h"
+#include "wchnet.h"
+#include "ModbusTCP.h"
+#include "ModbusRTU.h"
+#else
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+#define MAX_MIX            16
+#define ADU_MAX            260
+#define FRAME_OVERHEAD     54          // Ethernet 14 + IPv4 20 + TCP 20
+#define FRAME_MIN          60          // Ethernet minimum frame without FCS
+
+typedef struct
+{
+    uint8_t  fc;
+    uint32_t weight;
+    uint16_t qty;
+    uint32_t count;
+    uint32_t exceptions;
+    uint32_t cap;
+    uint32_t *lat;                     // Latency samples, ns
+} MixEntry;
+
+static MixEntry Mix[MAX_MIX];
+static uint8_t MixNum = 0;
+static uint32_t MixTotal = 0;
+
+static const char *Host = "127.0.0.1";
+static const char *Port = "502";
+static uint8_t Unit = 1;
+static uint16_t Addr = 0;
+static uint16_t AddrSpan = 0;
+static double Rate = 0;
+static double Duration = 10;
+static uint32_t MaxReq = 0;
+static uint32_t Seed = 1;
+
+static uint32_t *AllLat;
+static uint32_t LatNum = 0, LatCap = 0;
+static uint32_t Errors = 0;
+static uint64_t TxAdu = 0, RxAdu = 0, TxWire = 0, RxWire = 0;
+
+/*********************************************************************
+ * @fn      Now_ns
+ *
+ * @brief   Monotonic time.
+ *
+ * @return  time in ns
+ */
+static uint64_t Now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/*********************************************************************
+ * @fn      Rand32
+ *
+ * @brief   xorshift32, reproducible request sequence for a given seed.
+ *
+ * @return  random value
+ */
+static uint32_t Rand32(void)
+{
+    Seed ^= Seed << 13;
+    Seed ^= Seed >> 17;
+    Seed ^= Seed << 5;
+    return Seed;
+}
+
+static uint16_t DefaultQty(uint8_t fc)
+{
+    switch (fc)
+    {
+        case 1:  return 64;
+        case 3:  return 40;
+        case 15: return 16;
+        case 16: return 10;
+        default: return 1;
+    }
+}
+
+/*********************************************************************
+ * @fn      ParseMix
+ *
+ * @brief   Parse "fc:weight[:qty],..." into Mix[].
+ *
+ * @return  0 on success, -1 on error
+ */
+static int ParseMix(const char *arg)
+{
+    char buf[256], *tok, *save;
+    unsigned fc, weight, qty;
+    int n;
+
+    snprintf(buf, sizeof(buf), "%s", arg);
+    MixNum = 0;
+    MixTotal = 0;
+    for (tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save))
+    {
+        n = sscanf(tok, "%u:%u:%u", &fc, &weight, &qty);
+        if (n < 2 || MixNum >= MAX_MIX) return -1;
+        if (fc != 1 && fc != 3 && fc != 5 && fc != 6 && fc != 15 && fc != 16) return -1;
+        Mix[MixNum].fc = fc;
+        Mix[MixNum].weight = weight;
+        Mix[MixNum].qty = (n == 3) ? qty : DefaultQty(fc);
+        if (fc == 5 || fc == 6) Mix[MixNum].qty = 1;
+        MixTotal += weight;
+        MixNum++;
+    }
+    return (MixNum && MixTotal) ? 0 : -1;
+}
+
+/*********************************************************************
+ * @fn      BuildRequest
+ *
+ * @brief   Build a Modbus TCP ADU.
+ *
+ * @return  ADU length
+ */
+static uint16_t BuildRequest(uint8_t *buf, uint16_t tid, const MixEntry *m, uint16_t addr)
+{
+    uint16_t len = 12, i, nbytes;
+
+    buf[0] = tid >> 8;
+    buf[1] = tid;
+    buf[2] = 0;
+    buf[3] = 0;
+    buf[6] = Unit;
+    buf[7] = m->fc;
+    buf[8] = addr >> 8;
+    buf[9] = addr;
+
+    switch (m->fc)
+    {
+        case 5:                                             // ON/OFF alternating
+            buf[10] = (tid & 1) ? 0xFF : 0x00;
+            buf[11] = 0;
+            break;
+        case 6:
+            buf[10] = tid >> 8;
+            buf[11] = tid;
+            break;
+        case 15:
+            nbytes = (m->qty + 7) / 8;
+            buf[10] = m->qty >> 8;
+            buf[11] = m->qty;
+            buf[12] = nbytes;
+            for (i = 0; i < nbytes; i++) buf[13 + i] = (uint8_t) Rand32();
+            len = 13 + nbytes;
+            break;
+        case 16:
+            buf[10] = m->qty >> 8;
+            buf[11] = m->qty;
+            buf[12] = m->qty * 2;
+            for (i = 0; i < m->qty * 2; i++) buf[13 + i] = (uint8_t) Rand32();
+            len = 13 + m->qty * 2;
+            break;
+        default:                                            // Reads
+            buf[10] = m->qty >> 8;
+            buf[11] = m->qty;
+            break;
+    }
+    buf[4] = (len - 6) >> 8;
+    buf[5] = len - 6;
+    return len;
+}
+
+static uint32_t WireBytes(uint32_t adu)
+{
+    uint32_t frame = adu + FRAME_OVERHEAD;
+
+    return (frame < FRAME_MIN) ? FRAME_MIN : frame;
+}
+
+static void Record(MixEntry *m, uint32_t ns)
+{
+    if (LatNum == LatCap)
+    {
+        LatCap = LatCap ? LatCap * 2 : 65536;
+        AllLat = realloc(AllLat, LatCap * sizeof(uint32_t));
+    }
+    AllLat[LatNum++] = ns;
+    if (m->count == m->cap)
+    {
+        m->cap = m->cap ? m->cap * 2 : 4096;
+        m->lat = realloc(m->lat, m->cap * sizeof(uint32_t));
+    }
+    m->lat[m->count++] = ns;
+}
+
+static int CmpU32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+static double Pct(uint32_t *v, uint32_t n, double p)
+{
+    uint32_t i;
+
+    if (n == 0) return 0;
+    i = (uint32_t)(p * (n - 1) + 0.5);
+    return v[i] / 1000.0;
+}
+
+#ifdef MB_BENCH_INPROC
+
+/* Symbols normally provided by User/main.c, the WCHNET library, Host/ch32v30x_host.c
+   and Modbus/ModbusRTU.c (the bench only talks to unit 1, nothing goes to the RS-485 bus) */
+u16 PARAMETERSDataBuffer[12];
+volatile uint32_t LocalTime;
+SysTick_Type HOST_SysTick;
+MB_RTU_Stat MB_RTU_Stats;
+
+uint8_t MB_RTU_Submit(uint8_t prio, uint8_t flow, uint8_t unit, const uint8_t *pdu, uint16_t len,
+                      MB_RTU_DoneFn done, uint16_t tag)
+{
+    (void) prio; (void) flow; (void) unit; (void) pdu; (void) len; (void) done; (void) tag;
+    return 0x0B;
+}
+
+static uint8_t ReqBuf[ADU_MAX];                 /* Static, WCHNET addresses are 32 bits */
+static uint32_t ReqPos, ReqLen;
+static uint8_t RspBuf[ADU_MAX];
+static uint32_t RspLen;
+
+uint32_t WCHNET_SocketRecvLen(uint8_t socketid, uint32_t *bufaddr)
+{
+    (void) socketid;
+    if (bufaddr) *bufaddr = (uint32_t)(uintptr_t) &ReqBuf[ReqPos];
+    return ReqLen - ReqPos;
+}
+
+uint8_t WCHNET_SocketRecv(uint8_t socketid, uint8_t *buf, uint32_t *len)
+{
+    (void) socketid;
+    if (*len > ReqLen - ReqPos) *len = ReqLen - ReqPos;
+    if (buf) memcpy(buf, &ReqBuf[ReqPos], *len);
+    ReqPos += *len;
+    return WCHNET_ERR_SUCCESS;
+}
+
+uint8_t WCHNET_SocketSend(uint8_t socketid, uint8_t *buf, uint32_t *len)
+{
+    (void) socketid;
+    RspLen = (*len < sizeof(RspBuf)) ? *len : sizeof(RspBuf);
+    memcpy(RspBuf, buf, RspLen);
+    return WCHNET_ERR_SUCCESS;
+}
+
+uint8_t WCHNET_SocketClose(uint8_t socketid, uint8_t mode)
+{
+    (void) socketid; (void) mode;
+    return WCHNET_ERR_SUCCESS;
+}
+
+static int Transport_Open(void)
+{
+    return MB_Session_Open(0) ? 0 : -1;
+}
+
+static void Transport_Close(void)
+{
+}
+
+static int Transport_Transact(const uint8_t *req, uint16_t len, uint8_t *rsp, uint32_t *rsplen)
+{
+    memcpy(ReqBuf, req, len);
+    ReqPos = 0;
+    ReqLen = len;
+    RspLen = 0;
+    MB_TCP_Receive(0);
+    memcpy(rsp, RspBuf, RspLen);
+    *rsplen = RspLen;
+    return RspLen ? 0 : -1;
+}
+
+#else
+
+static int Sock = -1;
+
+static int Transport_Open(void)
+{
+    struct addrinfo hints, *res, *ai;
+    struct timeval tv = {1, 0};
+    int one = 1;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(Host, Port, &hints, &res) != 0) return -1;
+
+    for (ai = res; ai; ai = ai->ai_next)
+    {
+        Sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (Sock < 0) continue;
+        if (connect(Sock, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(Sock);
+        Sock = -1;
+    }
+    freeaddrinfo(res);
+    if (Sock < 0) return -1;
+
+    setsockopt(Sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(Sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return 0;
+}
+
+static void Transport_Close(void)
+{
+    if (Sock >= 0) close(Sock);
+    Sock = -1;
+}
+
+static int RecvAll(uint8_t *buf, uint32_t len)
+{
+    ssize_t n;
+
+    while (len)
+    {
+        n = recv(Sock, buf, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int Transport_Transact(const uint8_t *req, uint16_t len, uint8_t *rsp, uint32_t *rsplen)
+{
+    uint16_t follow;
+
+    if (send(Sock, req, len, MSG_NOSIGNAL) != len) return -1;
+    if (RecvAll(rsp, 6)) return -1;
+    follow = (rsp[4] << 8) | rsp[5];
+    if (follow == 0 || follow > ADU_MAX - 6) return -1;
+    if (RecvAll(rsp + 6, follow)) return -1;
+    *rsplen = 6 + follow;
+    return 0;
+}
+
+#endif
+
+static void Usage(const char *prog)
+{
+    printf("Usage: %s [options]\n"
+#ifndef MB_BENCH_INPROC
+           "  -H host       server address (127.0.0.1)\n"
+           "  -p port       server port (502)\n"
+           "  -r rate       requests/s on a fixed schedule, 0 = back to back (0)\n"
+#endif
+           "  -u unit       unit identifier (1)\n"
+           "  -m mix        fc:weight[:qty],... (1:30:64,3:30:40,5:10,6:10,15:10:16,16:10:10)\n"
+           "  -a addr       start address (0)\n"
+           "  -A span       randomize start address over [addr, addr+span) (0)\n"
+           "  -d seconds    run time (10)\n"
+           "  -n requests   stop after this many requests (0 = no limit)\n"
+           "  -s seed       request sequence seed (1)\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    uint8_t req[ADU_MAX], rsp[ADU_MAX];
+    uint64_t t0, tend, sched, start, done, period;
+    uint32_t i, pick, rsplen, total = 0;
+    uint16_t len, tid = 0, addr;
+    MixEntry *m;
+    double secs;
+    int opt;
+#ifdef MB_BENCH_INPROC
+    int saved_stdout, devnull;
+#endif
+
+    ParseMix("1:30:64,3:30:40,5:10,6:10,15:10:16,16:10:10");
+
+    while ((opt = getopt(argc, argv, "H:p:r:u:m:a:A:d:n:s:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'H': Host = optarg; break;
+            case 'p': Port = optarg; break;
+            case 'r': Rate = atof(optarg); break;
+            case 'u': Unit = atoi(optarg); break;
+            case 'm':
+                if (ParseMix(optarg)) {
+                    fprintf(stderr, "Bad mix: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'a': Addr = atoi(optarg); break;
+            case 'A': AddrSpan = atoi(optarg); break;
+            case 'd': Duration = atof(optarg); break;
+            case 'n': MaxReq = strtoul(optarg, NULL, 0); break;
+            case 's': Seed = strtoul(optarg, NULL, 0) | 1; break;
+            default:
+                Usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (Transport_Open())
+    {
+        fprintf(stderr, "Cannot connect to %s:%s\n", Host, Port);
+        return 1;
+    }
+
+#ifdef MB_BENCH_INPROC
+    // The handlers print to stdout, keep that out of the measurement output
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDOUT_FILENO);
+#endif
+
+    period = (Rate > 0) ? (uint64_t)(1e9 / Rate) : 0;
+    t0 = Now_ns();
+    tend = t0 + (uint64_t)(Duration * 1e9);
+    sched = t0;
+
+    while (1)
+    {
+        if (MaxReq && total >= MaxReq) break;
+        if (period)
+        {
+            struct timespec ts;
+
+            sched = t0 + total * period;
+            ts.tv_sec = sched / 1000000000ull;
+            ts.tv_nsec = sched % 1000000000ull;
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        }
+        if (Now_ns() >= tend) break;
+
+        pick = Rand32() % MixTotal;
+        for (i = 0; i + 1 < MixNum && pick >= Mix[i].weight; i++)
+            pick -= Mix[i].weight;
+        m = &Mix[i];
+
+        addr = AddrSpan ? Addr + Rand32() % AddrSpan : Addr;
+        len = BuildRequest(req, ++tid, m, addr);
+
+        start = Now_ns();
+        if (Transport_Transact(req, len, rsp, &rsplen) || rsp[0] != req[0] || rsp[1] != req[1])
+        {
+            Errors++;
+            total++;
+            Transport_Close();
+            if (Transport_Open()) break;
+            continue;
+        }
+        done = Now_ns();
+
+        if (rsp[7] & 0x80) m->exceptions++;
+        Record(m, (uint32_t)(done - (period ? sched : start)));
+        TxAdu += len;
+        RxAdu += rsplen;
+        TxWire += WireBytes(len);
+        RxWire += WireBytes(rsplen);
+        total++;
+    }
+    secs = (Now_ns() - t0) / 1e9;
+    Transport_Close();
+
+#ifdef MB_BENCH_INPROC
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(devnull);
+    close(saved_stdout);
+#endif
+
+    qsort(AllLat, LatNum, sizeof(uint32_t), CmpU32);
+    printf("requests        : %u (%u errors)\n", total, Errors);
+    printf("duration        : %.3f s\n", secs);
+    printf("throughput      : %.1f req/s\n", LatNum / secs);
+    printf("latency us      : p50 %.2f  p99 %.2f  p999 %.2f  max %.2f\n",
+           Pct(AllLat, LatNum, 0.5), Pct(AllLat, LatNum, 0.99), Pct(AllLat, LatNum, 0.999),
+           Pct(AllLat, LatNum, 1.0));
+    if (LatNum)
+    {
+        printf("ADU bytes       : tx %llu  rx %llu  (%.1f per request)\n",
+               (unsigned long long) TxAdu, (unsigned long long) RxAdu, (double)(TxAdu + RxAdu) / LatNum);
+        printf("wire bytes      : tx %llu  rx %llu  (%.1f per request)\n",
+               (unsigned long long) TxWire, (unsigned long long) RxWire, (double)(TxWire + RxWire) / LatNum);
+    }
+    for (i = 0; i < MixNum; i++)
+    {
+        m = &Mix[i];
+        qsort(m->lat, m->count, sizeof(uint32_t), CmpU32);
+        printf("FC%02u qty %-5u  : %8u req  %6u exc  p50 %.2f  p99 %.2f us\n", m->fc, m->qty,
+               m->count, m->exceptions, Pct(m->lat, m->count, 0.5), Pct(m->lat, m->count, 0.99));
+    }
+    return Errors ? 2 : 0;
+}
@@ -0,0 +1,263 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : ch32v30x_host.c
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Host (Linux) emulation of the CH32V30x peripherals used
+ *                      by User/main.c. GPIO, RCC, EXTI and FLASH calls
+ *                      are no-ops, SysTick and TIM2 are driven by a 1 ms
+ *                      interval timer (SIGALRM) so the firmware delays and the
+ *                      WCHNET timer keep working. USART2 and its DMA channels
+ *                      (Modbus RTU master) are a pseudo terminal, the slave
+ *                      side is printed at start and linked to $HOST_USART2.
+*********************************************************************************/
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "eth_driver.h"
+#include "ModbusRTU.h"
+
+#define HOST_CHIPID        0x30700528     // Reported by DBGMCU_GetCHIPID
+
+extern volatile uint32_t TimingDelay;
+extern volatile uint32_t WEBSOCKETTimingDelay;
+
+GPIO_TypeDef  HOST_GPIOA, HOST_GPIOB;
+SysTick_Type  HOST_SysTick;
+USART_TypeDef HOST_USART2;
+TIM_TypeDef   HOST_TIM2;
+DMA_Channel_TypeDef HOST_DMA1_Channel6, HOST_DMA1_Channel7;
+
+uint32_t SystemCoreClock = 144000000;
+
+static volatile uint8_t systick_enabled = 0;
+static volatile uint8_t tim2_enabled = 0;
+static volatile uint32_t tim2_ms = 0;
+static uint8_t timer_started = 0;
+
+static int usart2_fd = -1;               // Pseudo terminal master, the RS-485 bus
+static uint32_t dma_flags;               // DMA1 flags, DMA1_FLAG_TC7
+static uint16_t dma_rx_len;              // Channel 6 counter when it was enabled
+
+/*********************************************************************
+ * @fn      Host_TickHandler
+ *
+ * @brief   1 ms tick, does the work of SysTick_Handler and TIM2_IRQHandler.
+ *
+ * @return  none
+ */
+static void Host_TickHandler(int sig)
+{
+    (void) sig;
+
+    if (systick_enabled)
+    {
+        if (TimingDelay != 0x00) TimingDelay--;
+        if (WEBSOCKETTimingDelay != 0x00) WEBSOCKETTimingDelay--;
+        MB_RTU_TimeIsr(1);
+    }
+    if (tim2_enabled)
+    {
+        if (++tim2_ms >= WCHNETTIMERPERIOD)
+        {
+            tim2_ms = 0;
+            WCHNET_TimeIsr(WCHNETTIMERPERIOD);
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn      Host_StartTimer
+ *
+ * @brief   Start the 1 ms interval timer on first use.
+ *
+ * @return  none
+ */
+static void Host_StartTimer(void)
+{
+    struct sigaction sa;
+    struct itimerval it;
+
+    if (timer_started) return;
+    timer_started = 1;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = Host_TickHandler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGALRM, &sa, NULL);
+
+    it.it_interval.tv_sec = 0;
+    it.it_interval.tv_usec = 1000;
+    it.it_value = it.it_interval;
+    setitimer(ITIMER_REAL, &it, NULL);
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn == SysTicK_IRQn) systick_enabled = 1;
+    if (IRQn == TIM2_IRQn) tim2_enabled = 1;
+    Host_StartTimer();
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn == SysTicK_IRQn) systick_enabled = 0;
+    if (IRQn == TIM2_IRQn) tim2_enabled = 0;
+}
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint8_t priority) { (void) IRQn; (void) priority; }
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct) { (void) NVIC_InitStruct; }
+
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState) { (void) RCC_AHBPeriph; (void) NewState; }
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState) { (void) RCC_APB1Periph; (void) NewState; }
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) { (void) RCC_APB2Periph; (void) NewState; }
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct) { (void) GPIOx; (void) GPIO_InitStruct; }
+void GPIO_EXTILineConfig(uint8_t GPIO_PortSource, uint8_t GPIO_PinSource) { (void) GPIO_PortSource; (void) GPIO_PinSource; }
+
+/* Inputs have pull-ups, so a button that is never pressed reads high */
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) { (void) GPIOx; (void) GPIO_Pin; return 1; }
+void GPIO_SetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) { GPIOx->OUTDR |= GPIO_Pin; }
+void GPIO_ResetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) { GPIOx->OUTDR &= ~GPIO_Pin; }
+
+void EXTI_Init(EXTI_InitTypeDef *EXTI_InitStruct) { (void) EXTI_InitStruct; }
+
+void TIM_TimeBaseInit(TIM_TypeDef *TIMx, TIM_TimeBaseInitTypeDef *TIM_TimeBaseInitStruct) { (void) TIMx; (void) TIM_TimeBaseInitStruct; }
+void TIM_ITConfig(TIM_TypeDef *TIMx, uint16_t TIM_IT, FunctionalState NewState) { (void) TIMx; (void) TIM_IT; (void) NewState; }
+void TIM_Cmd(TIM_TypeDef *TIMx, FunctionalState NewState) { (void) TIMx; (void) NewState; }
+void TIM_ClearITPendingBit(TIM_TypeDef *TIMx, uint16_t TIM_IT) { (void) TIMx; (void) TIM_IT; }
+
+/*********************************************************************
+ * @fn      USART_Init
+ *
+ * @brief   USART2 is opened as a pseudo terminal in raw mode. The slave side
+ *          stays open here as well, so the bus exists before a device attaches.
+ *
+ * @return  none
+ */
+void USART_Init(USART_TypeDef *USARTx, USART_InitTypeDef *USART_InitStruct)
+{
+    struct termios tio;
+    const char *name, *link;
+    int fd;
+
+    (void) USART_InitStruct;
+    if ((USARTx != USART2) || (usart2_fd >= 0)) return;
+
+    usart2_fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if ((usart2_fd < 0) || grantpt(usart2_fd) || unlockpt(usart2_fd) || ((name = ptsname(usart2_fd)) == NULL))
+    {
+        printf("USART2: no pseudo terminal\n");
+        return;
+    }
+    fd = open(name, O_RDWR | O_NOCTTY);
+    if ((fd >= 0) && (tcgetattr(fd, &tio) == 0))
+    {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    link = getenv("HOST_USART2");
+    if (link != NULL)
+    {
+        unlink(link);
+        if (symlink(name, link) == 0) name = link;
+    }
+    printf("USART2 (RS-485) on %s\n", name);
+}
+
+void USART_Cmd(USART_TypeDef *USARTx, FunctionalState NewState) { (void) USARTx; (void) NewState; }
+void USART_DMACmd(USART_TypeDef *USARTx, uint16_t USART_DMAReq, FunctionalState NewState) { (void) USARTx; (void) USART_DMAReq; (void) NewState; }
+void USART_SendData(USART_TypeDef *USARTx, uint16_t Data) { USARTx->DATAR = Data; }
+uint16_t USART_ReceiveData(USART_TypeDef *USARTx) { return USARTx->DATAR; }
+FlagStatus USART_GetFlagStatus(USART_TypeDef *USARTx, uint16_t USART_FLAG) { (void) USARTx; (void) USART_FLAG; return SET; }
+void USART_ClearFlag(USART_TypeDef *USARTx, uint16_t USART_FLAG) { (void) USARTx; (void) USART_FLAG; }
+
+void DMA_DeInit(DMA_Channel_TypeDef *DMAy_Channelx) { memset((void *) DMAy_Channelx, 0, sizeof(*DMAy_Channelx)); }
+
+void DMA_Init(DMA_Channel_TypeDef *DMAy_Channelx, DMA_InitTypeDef *DMA_InitStruct)
+{
+    DMAy_Channelx->CFGR = DMA_InitStruct->DMA_DIR | DMA_InitStruct->DMA_MemoryInc | DMA_InitStruct->DMA_Priority;
+    DMAy_Channelx->CNTR = DMA_InitStruct->DMA_BufferSize;
+    DMAy_Channelx->PADDR = DMA_InitStruct->DMA_PeripheralBaseAddr;
+    DMAy_Channelx->MADDR = DMA_InitStruct->DMA_MemoryBaseAddr;
+}
+
+/*********************************************************************
+ * @fn      DMA_Cmd
+ *
+ * @brief   Channel 7 (USART2 TX) writes the whole transfer to the pseudo terminal
+ *          when enabled. Channel 6 (USART2 RX) drops what came in while it was
+ *          off, as the chip does, and is then filled by DMA_GetCurrDataCounter.
+ *
+ * @return  none
+ */
+void DMA_Cmd(DMA_Channel_TypeDef *DMAy_Channelx, FunctionalState NewState)
+{
+    if (NewState == DISABLE)
+    {
+        DMAy_Channelx->CFGR &= ~1UL;
+        return;
+    }
+    DMAy_Channelx->CFGR |= 1;
+
+    if (DMAy_Channelx == DMA1_Channel7)
+    {
+        if (usart2_fd >= 0)
+            (void) write(usart2_fd, (const void *)(uintptr_t) DMAy_Channelx->MADDR, DMAy_Channelx->CNTR);
+        DMAy_Channelx->CNTR = 0;
+        dma_flags |= DMA1_FLAG_TC7;
+    }
+    else if (DMAy_Channelx == DMA1_Channel6)
+    {
+        if (usart2_fd >= 0)
+            tcflush(usart2_fd, TCIFLUSH);
+        dma_rx_len = DMAy_Channelx->CNTR;
+    }
+}
+
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef *DMAy_Channelx, uint16_t DataNumber) { DMAy_Channelx->CNTR = DataNumber; }
+
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef *DMAy_Channelx)
+{
+    ssize_t n;
+
+    if ((DMAy_Channelx == DMA1_Channel6) && (DMAy_Channelx->CFGR & 1) && DMAy_Channelx->CNTR && (usart2_fd >= 0))
+    {
+        n = read(usart2_fd, (uint8_t *)(uintptr_t) DMAy_Channelx->MADDR + (dma_rx_len - DMAy_Channelx->CNTR), DMAy_Channelx->CNTR);
+        if (n > 0) DMAy_Channelx->CNTR -= n;
+    }
+    return DMAy_Channelx->CNTR;
+}
+
+FlagStatus DMA_GetFlagStatus(uint32_t DMAy_FLAG) { return (dma_flags & DMAy_FLAG) ? SET : RESET; }
+void DMA_ClearFlag(uint32_t DMAy_FLAG) { dma_flags &= ~DMAy_FLAG; }
+
+void FLASH_Unlock(void) {}
+void FLASH_Lock(void) {}
+void FLASH_Unlock_Fast(void) {}
+void FLASH_Lock_Fast(void) {}
+void FLASH_ErasePage_Fast(uint32_t Page_Address) { (void) Page_Address; }
+FLASH_Status FLASH_ProgramWord(uint32_t Address, uint32_t Data) { (void) Address; (void) Data; return FLASH_COMPLETE; }
+
+uint32_t DBGMCU_GetCHIPID(void) { return HOST_CHIPID; }
+
+void SystemCoreClockUpdate(void) {}
+
+void Delay_Init(void) {}
+void Delay_Us(uint32_t n) { (void) n; }
+void Delay_Ms(uint32_t n) { (void) n; }
+void SDI_Printf_Enable(void) {}
+
+void USART_Printf_Init(uint32_t baudrate)
+{
+    (void) baudrate;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
@@ -0,0 +1,1117 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : mb_fuzz.c
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Modbus TCP fuzz target and conformance suite.
+*********************************************************************************/
+
+/*
+    Feeds a byte stream to MB_TCP_Receive (and so MB_Parse_Data and the function
+    code handlers) the way WCHNET hands it over, and checks every response against
+    a reference model of the Modbus application protocol kept in this file. The
+    model shares nothing with Modbus/ModbusMap.c or the handlers, only the region
+    list of the test register map below, which is the specification.
+
+    Test input: byte 0 chooses how the stream is cut into receives (0: one receive,
+    n: 1 .. 4n bytes each, from a generator seeded with n), the rest is the stream.
+    The last byte of each receive is the last byte of its buffer, a read past it is
+    caught by AddressSanitizer.
+
+    Checked for unit ids served locally (all but 2 .. 19):
+      - every complete ADU gets exactly one response, in order, byte for byte the
+        one the model gives (FC43 and FC65: the framing only)
+      - exception codes and their order of precedence: 01 function code,
+        03 quantity / byte count / value, 02 address, as in the Modbus spec
+      - a write changes exactly the addressed items, nothing else in the map
+      - a bad MBAP length field gets exception 04 (unit id and function code 0
+        if not yet received), the stream is out of sync from there on and only
+        the framing of the responses is checked
+    Unit ids 2 .. 9 go to a gateway transport answering each request with its
+    own PDU, 10 .. 19 to one that always fails: each such request gets one
+    response, the echo or exception 06 / 0B.
+
+    Builds (see Host/Makefile):
+      make fuzz        build/mb_fuzz with AddressSanitizer and UBSan, runs inputs:
+                         build/mb_fuzz file ...        replay test inputs
+                         build/mb_fuzz < file          one input on stdin (AFL: @@ or stdin)
+                         build/mb_fuzz -c              conformance suite: FC01, FC02, FC15
+                                                       at every alignment round the region
+                                                       boundaries, FC05 values
+                         build/mb_fuzz -n 100000 [-s seed]
+                                                       generated request streams
+                       a failed run saves its input to mb_fuzz-failure.bin
+      make check       build/mb_fuzz -c -n 20000
+      make fuzz CC=clang FUZZ_ENGINE=-fsanitize=fuzzer
+                       libFuzzer build, build/mb_fuzz is then the libFuzzer driver
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "debug.h"
+#include "wchnet.h"
+#include "ModbusTCP.h"
+#include "ModbusMap.h"
+#include "ModbusDevId.h"
+#include "ModbusGateway.h"
+
+#define INPUT_MAX          16384
+#define FRAME_MAX          (INPUT_MAX / 8)     // ADUs in one input, 8 bytes at least
+#define OUT_MAX            (FRAME_MAX * TCP_ADU_MAX)
+#define SUB_MAX            MB_GW_ENTRY_NUM
+
+#define GW_ECHO_FIRST      2                   // Gateway units answered with the request PDU
+#define GW_ECHO_LAST       9
+#define GW_FAIL_FIRST      10                  // Gateway units that never answer
+#define GW_FAIL_LAST       19
+
+#define EXP_EXACT          0                   // Expected response kinds
+#define EXP_DEVID          1                   // FC43 response, framing only
+#define EXP_CHANGES        2                   // FC65 response, framing only
+#define EXP_BAD_MBAP       3                   // Exception 04, unit id and function code may be 0
+#define EXP_GW_ECHO        4                   // Echo, or exception 06
+#define EXP_GW_FAIL        5                   // Exception 0B or 06
+
+typedef struct
+{
+    uint8_t Kind;                              // EXP_xxx
+    uint8_t Done;                              // Matched by a response
+    uint16_t Len;                              // Bytes in Adu
+    uint8_t Adu[TCP_ADU_MAX];                  // Response, or the request for EXP_GW_xxx
+} Expect;
+
+/* Symbols normally provided by User/main.c, the WCHNET library and Host/ch32v30x_host.c */
+volatile uint32_t LocalTime;
+SysTick_Type HOST_SysTick;
+
+/* Test register map -------------------------------------------------------------------*/
+static uint32_t CoilA[256 / 32], CoilB[64 / 32], CoilTop[32 / 32];
+static uint32_t DinA[64 / 32], DinB[32 / 32];
+static uint16_t RegA[100], RegB[10], RegCb[8], RegTop[6];
+static uint16_t InBuf[2][64];
+static MB_Bank InBank = { 0, { InBuf[0], InBuf[1] }, sizeof(InBuf[0]) };
+
+static uint8_t RegCb_Read(uint16_t offset, uint16_t count, uint8_t *dst)
+{
+    while (count--)
+    {
+        *dst++ = RegCb[offset];
+        *dst++ = RegCb[offset++] >> 8;
+    }
+    return 0;
+}
+
+static uint8_t RegCb_Write(uint16_t offset, uint16_t count, const uint8_t *src)
+{
+    for (; count; count--, src += 2)
+        RegCb[offset++] = src[0] | (src[1] << 8);
+    return 0;
+}
+
+static uint8_t InCb_Read(uint16_t offset, uint16_t count, uint8_t *dst)
+{
+    for (; count; count--, offset++)
+    {
+        *dst++ = 0x1000 + offset;
+        *dst++ = (0x1000 + offset) >> 8;
+    }
+    return 0;
+}
+
+static const MB_Region CoilRegions[] = {
+    {     0,  256,  0,              CoilA,    NULL,        NULL },
+    {  1000,  64,   MB_REGION_RO,   CoilB,    NULL,        NULL },
+    { 65504,  32,   0,              CoilTop,  NULL,        NULL },
+};
+
+static const MB_Region DiscreteRegions[] = {
+    {     0,  64,   MB_REGION_RO,   DinA,     NULL,        NULL },
+    {   100,  32,   MB_REGION_RO,   DinB,     NULL,        NULL },
+};
+
+static const MB_Region HoldingRegions[] = {
+    {     0,  100,  MB_REGION_JOURNAL, RegA,  NULL,        NULL },
+    {   200,  10,   MB_REGION_RO,   RegB,     NULL,        NULL },
+    {   300,  8,    0,              NULL,     RegCb_Read,  RegCb_Write },
+    { 65530,  6,    0,              RegTop,   NULL,        NULL },
+};
+
+static const MB_Region InputRegions[] = {
+    {     0,  64,   MB_REGION_BANK, &InBank,  NULL,        NULL },
+    {   500,  4,    0,              NULL,     InCb_Read,   NULL },
+};
+
+#define REGION_NUM(t)   (sizeof(t) / sizeof((t)[0]))
+
+const MB_Table MB_Map[MB_SPACE_NUM] = {
+    [MB_SPACE_COILS]    = { CoilRegions,     REGION_NUM(CoilRegions) },
+    [MB_SPACE_DISCRETE] = { DiscreteRegions, REGION_NUM(DiscreteRegions) },
+    [MB_SPACE_HOLDING]  = { HoldingRegions,  REGION_NUM(HoldingRegions) },
+    [MB_SPACE_INPUT]    = { InputRegions,    REGION_NUM(InputRegions) },
+};
+
+/* Gateway transports ------------------------------------------------------------------*/
+static uint16_t SubTag[SUB_MAX], SubLen[SUB_MAX];
+static uint8_t SubPdu[SUB_MAX][MB_GW_PDU_MAX];
+static uint8_t SubNum;
+
+static uint8_t Echo_Submit(uint8_t client, uint8_t unit, const uint8_t *pdu, uint16_t len, uint16_t tag)
+{
+    (void) client; (void) unit;
+    if (SubNum == SUB_MAX)
+        return 0x06;
+    SubTag[SubNum] = tag;
+    SubLen[SubNum] = len;
+    memcpy(SubPdu[SubNum++], pdu, len);
+    return 0;
+}
+
+static uint8_t Fail_Submit(uint8_t client, uint8_t unit, const uint8_t *pdu, uint16_t len, uint16_t tag)
+{
+    (void) client; (void) unit; (void) pdu; (void) len; (void) tag;
+    return 0x0B;
+}
+
+static const MB_GW_Route GatewayRoutes[] = {
+    { GW_ECHO_FIRST, GW_ECHO_LAST, Echo_Submit },
+    { GW_FAIL_FIRST, GW_FAIL_LAST, Fail_Submit },
+};
+
+const MB_GW_Table MB_GW_Routes = { GatewayRoutes, REGION_NUM(GatewayRoutes) };
+
+/* WCHNET socket calls -----------------------------------------------------------------*/
+static uint8_t RxBuf[INPUT_MAX];                // Static, WCHNET addresses are 32 bits
+static uint32_t RxOff, RxFreed;
+static uint8_t Out[OUT_MAX];
+static uint32_t OutLen;
+
+uint32_t WCHNET_SocketRecvLen(uint8_t socketid, uint32_t *bufaddr)
+{
+    (void) socketid;
+    if (bufaddr) *bufaddr = (uint32_t)(uintptr_t) &RxBuf[RxOff];
+    return sizeof(RxBuf) - RxOff;
+}
+
+uint8_t WCHNET_SocketRecv(uint8_t socketid, uint8_t *buf, uint32_t *len)
+{
+    (void) socketid; (void) buf;
+    RxFreed += *len;
+    return WCHNET_ERR_SUCCESS;
+}
+
+// Takes at most 64 bytes per call, like a socket with little send buffer left,
+// so the firmware has to send the rest of a batch itself
+uint8_t WCHNET_SocketSend(uint8_t socketid, uint8_t *buf, uint32_t *len)
+{
+    (void) socketid;
+    if (*len > 64) *len = 64;
+    if (OutLen + *len > sizeof(Out))
+    {
+        fprintf(stderr, "mb_fuzz: more response bytes than requests can produce\n");
+        abort();
+    }
+    memcpy(&Out[OutLen], buf, *len);
+    OutLen += *len;
+    return WCHNET_ERR_SUCCESS;
+}
+
+uint8_t WCHNET_SocketClose(uint8_t socketid, uint8_t mode)
+{
+    (void) socketid; (void) mode;
+    fprintf(stderr, "mb_fuzz: connection closed, the socket took less than offered\n");
+    abort();
+}
+
+/* Reference model ---------------------------------------------------------------------*/
+static int8_t RefRegion[MB_SPACE_NUM][0x10000];  // Region of each address, -1 if none
+static uint8_t RefWritable[MB_SPACE_NUM][8];
+static uint16_t RefVal[MB_SPACE_NUM][0x10000];   // Value of each item, bits 0 / 1
+static Expect Exp[FRAME_MAX];
+static uint16_t ExpNum;
+static uint8_t Desync;                           // Bad MBAP length seen, stream out of sync
+
+static uint32_t RandState = 1;                   // Generated streams
+
+static uint32_t Xorshift(uint32_t *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+static uint32_t Rand32(void)
+{
+    return Xorshift(&RandState);
+}
+
+static uint16_t Be16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static int Gw_Unit(uint8_t unit)
+{
+    return (unit >= GW_ECHO_FIRST) && (unit <= GW_FAIL_LAST);
+}
+
+// Request e is answered by the local server, in order
+static int Local_Exp(const Expect *e)
+{
+    return (e->Kind < EXP_GW_ECHO) && ((e->Kind == EXP_BAD_MBAP) || !Gw_Unit(e->Adu[6]));
+}
+
+// Item n of region i as the firmware holds it, straight from the backing array
+static uint16_t Ref_Actual(uint8_t space, uint8_t i, uint16_t n)
+{
+    const MB_Region *r = &MB_Map[space].Regions[i];
+
+    if (r->Read == RegCb_Read)
+        return RegCb[n];
+    if (r->Read == InCb_Read)
+        return 0x1000 + n;
+    if (r->Flags & MB_REGION_BANK)
+        return ((const uint16_t *) InBank.Buf[(InBank.Seq >> 1) & 1])[n];
+    if (MB_SPACE_IS_BITS(space))
+        return (((const uint32_t *) r->Data)[n / 32] >> (n % 32)) & 1;
+    return ((const uint16_t *) r->Data)[n];
+}
+
+// Region holding the whole range, -1 if none
+static int Ref_Range(uint8_t space, uint32_t addr, uint32_t count)
+{
+    int r = RefRegion[space][addr];
+
+    if ((addr + count - 1 > 0xFFFF) || (r < 0) || (RefRegion[space][addr + count - 1] != r))
+        return -1;
+    return r;
+}
+
+// Fills the map with the same values for every input, the model takes them from the backing arrays
+static void Ref_Reset(void)
+{
+    const MB_Region *r;
+    uint32_t x = 0x2545F491, n, k;
+    uint16_t *bank;
+    uint8_t s, i;
+
+    for (k = 0; k < sizeof(CoilA) / 4; k++) CoilA[k] = Xorshift(&x);
+    for (k = 0; k < sizeof(CoilB) / 4; k++) CoilB[k] = Xorshift(&x);
+    for (k = 0; k < sizeof(CoilTop) / 4; k++) CoilTop[k] = Xorshift(&x);
+    for (k = 0; k < sizeof(DinA) / 4; k++) DinA[k] = Xorshift(&x);
+    for (k = 0; k < sizeof(DinB) / 4; k++) DinB[k] = Xorshift(&x);
+    for (k = 0; k < 100; k++) RegA[k] = Xorshift(&x);
+    for (k = 0; k < 10; k++) RegB[k] = Xorshift(&x);
+    for (k = 0; k < 8; k++) RegCb[k] = Xorshift(&x);
+    for (k = 0; k < 6; k++) RegTop[k] = Xorshift(&x);
+    bank = MB_Bank_Begin(&InBank);
+    for (k = 0; k < 64; k++) bank[k] = Xorshift(&x);
+    MB_Bank_Publish(&InBank);
+
+    memset(RefRegion, -1, sizeof(RefRegion));
+    for (s = 0; s < MB_SPACE_NUM; s++)
+    {
+        for (i = 0; i < MB_Map[s].Num; i++)
+        {
+            r = &MB_Map[s].Regions[i];
+            RefWritable[s][i] = !(r->Flags & (MB_REGION_RO | MB_REGION_BANK)) && ((r->Data != NULL) || (r->Write != NULL));
+            for (n = 0; n < r->Count; n++)
+            {
+                RefRegion[s][r->Start + n] = i;
+                RefVal[s][r->Start + n] = Ref_Actual(s, i, n);
+            }
+        }
+    }
+}
+
+// Every item of the map as the firmware holds it equals the model
+static int Ref_Compare(void)
+{
+    const MB_Region *r;
+    uint8_t s, i;
+    uint32_t n;
+
+    for (s = 0; s < MB_SPACE_NUM; s++)
+    {
+        for (i = 0; i < MB_Map[s].Num; i++)
+        {
+            r = &MB_Map[s].Regions[i];
+            for (n = 0; n < r->Count; n++)
+            {
+                if (Ref_Actual(s, i, n) != RefVal[s][r->Start + n])
+                {
+                    fprintf(stderr, "mb_fuzz: space %u address %u holds %u, the model %u\n", s,
+                            r->Start + n, Ref_Actual(s, i, n), RefVal[s][r->Start + n]);
+                    return -1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static Expect *Ref_Exception(Expect *e, const uint8_t *f, uint8_t ex)
+{
+    memcpy(e->Adu, f, 4);
+    e->Adu[4] = 0;
+    e->Adu[5] = 3;
+    e->Adu[6] = f[6];
+    e->Adu[7] = f[7] | 0x80;
+    e->Adu[8] = ex;
+    e->Len = 9;
+    return e;
+}
+
+// Response header, pdu bytes after the unit id
+static Expect *Ref_Header(Expect *e, const uint8_t *f, uint16_t pdu)
+{
+    memcpy(e->Adu, f, 4);
+    e->Adu[4] = (pdu + 1) >> 8;
+    e->Adu[5] = pdu + 1;
+    e->Adu[6] = f[6];
+    e->Adu[7] = f[7];
+    e->Len = 7 + pdu;
+    return e;
+}
+
+static void Ref_Read(Expect *e, uint8_t space, uint16_t addr, uint16_t q)
+{
+    uint16_t i, v;
+
+    if (MB_SPACE_IS_BITS(space))
+    {
+        e->Adu[8] = (q + 7) / 8;
+        memset(&e->Adu[9], 0, e->Adu[8]);
+        for (i = 0; i < q; i++)
+            e->Adu[9 + i / 8] |= RefVal[space][addr + i] << (i % 8);
+    }
+    else
+    {
+        e->Adu[8] = q * 2;
+        for (i = 0; i < q; i++)
+        {
+            v = RefVal[space][addr + i];
+            e->Adu[9 + 2 * i] = v;                  // Low byte first, as this device sends registers
+            e->Adu[10 + 2 * i] = v >> 8;
+        }
+    }
+}
+
+// Expected response to one complete ADU of n = length field bytes
+static void Ref_Respond(const uint8_t *f, uint16_t n)
+{
+    Expect *e = &Exp[ExpNum++];
+    uint8_t unit = f[6], fc = f[7], space, bc;
+    uint16_t addr = Be16(&f[8]), q = Be16(&f[10]), i, v, waddr, wq;
+    int r;
+
+    e->Kind = EXP_EXACT;
+    e->Done = 0;
+
+    memcpy(e->Adu, f, 6 + n);                            // The request, until a response is known
+    e->Len = 6 + n;
+    if (Gw_Unit(unit))
+    {
+        e->Kind = (unit <= GW_ECHO_LAST) ? EXP_GW_ECHO : EXP_GW_FAIL;
+        return;
+    }
+
+    switch (fc)
+    {
+    case 0x01: case 0x02: case 0x03: case 0x04: case 0x05: case 0x06:
+        if (n != 6) { Ref_Exception(e, f, 0x03); return; }
+        break;
+    case 0x0F: case 0x10:
+        if ((n < 7) || (n > 254)) { Ref_Exception(e, f, 0x03); return; }
+        break;
+    case 0x16:
+        if (n != 8) { Ref_Exception(e, f, 0x03); return; }
+        break;
+    case 0x17:
+        if ((n < 13) || (n > 254)) { Ref_Exception(e, f, 0x03); return; }
+        break;
+    case 0x2B:
+        if (n != 5) { Ref_Exception(e, f, 0x03); return; }
+        if (f[8] != 0x0E) { Ref_Exception(e, f, 0x01); return; }
+        e->Kind = EXP_DEVID;
+        return;
+    case 0x41:
+        if (n != 7) { Ref_Exception(e, f, 0x03); return; }
+        if ((f[12] == 0) || (f[12] > TCP_CHANGES_MAX)) { Ref_Exception(e, f, 0x03); return; }
+        e->Kind = EXP_CHANGES;
+        return;
+    default:
+        Ref_Exception(e, f, 0x01);
+        return;
+    }
+
+    switch (fc)
+    {
+    case 0x01: case 0x02: case 0x03: case 0x04:
+        space = (fc == 0x01) ? MB_SPACE_COILS : (fc == 0x02) ? MB_SPACE_DISCRETE :
+                (fc == 0x03) ? MB_SPACE_HOLDING : MB_SPACE_INPUT;
+        if ((q == 0) || (q > (MB_SPACE_IS_BITS(space) ? 2000 : 125)))
+            Ref_Exception(e, f, 0x03);
+        else if (Ref_Range(space, addr, q) < 0)
+            Ref_Exception(e, f, 0x02);
+        else
+            Ref_Read(Ref_Header(e, f, 2 + (MB_SPACE_IS_BITS(space) ? (q + 7) / 8 : q * 2)), space, addr, q);
+        return;
+
+    case 0x05:
+        if ((q != 0xFF00) && (q != 0x0000))
+            Ref_Exception(e, f, 0x03);
+        else if (((r = Ref_Range(MB_SPACE_COILS, addr, 1)) < 0) || !RefWritable[MB_SPACE_COILS][r])
+            Ref_Exception(e, f, 0x02);
+        else
+        {
+            RefVal[MB_SPACE_COILS][addr] = (q == 0xFF00);
+            memcpy(Ref_Header(e, f, 5)->Adu + 8, &f[8], 4);
+        }
+        return;
+
+    case 0x06:
+        if (((r = Ref_Range(MB_SPACE_HOLDING, addr, 1)) < 0) || !RefWritable[MB_SPACE_HOLDING][r])
+            Ref_Exception(e, f, 0x02);
+        else
+        {
+            RefVal[MB_SPACE_HOLDING][addr] = f[10] | (f[11] << 8);
+            memcpy(Ref_Header(e, f, 5)->Adu + 8, &f[8], 4);
+        }
+        return;
+
+    case 0x0F: case 0x10:
+        space = (fc == 0x0F) ? MB_SPACE_COILS : MB_SPACE_HOLDING;
+        bc = (fc == 0x0F) ? (q + 7) / 8 : q * 2;
+        if ((q == 0) || (q > ((fc == 0x0F) ? 1968 : 123)) || (f[12] != bc) || (n != 7 + bc))
+            Ref_Exception(e, f, 0x03);
+        else if (((r = Ref_Range(space, addr, q)) < 0) || !RefWritable[space][r])
+            Ref_Exception(e, f, 0x02);
+        else
+        {
+            for (i = 0; i < q; i++)
+                RefVal[space][addr + i] = (fc == 0x0F) ? ((f[13 + i / 8] >> (i % 8)) & 1) :
+                                                         (f[13 + 2 * i] | (f[14 + 2 * i] << 8));
+            memcpy(Ref_Header(e, f, 5)->Adu + 8, &f[8], 4);
+        }
+        return;
+
+    case 0x16:
+        if (((r = Ref_Range(MB_SPACE_HOLDING, addr, 1)) < 0) || !RefWritable[MB_SPACE_HOLDING][r])
+            Ref_Exception(e, f, 0x02);
+        else
+        {
+            v = RefVal[MB_SPACE_HOLDING][addr];
+            q = f[10] | (f[11] << 8);                   // AND mask, register byte order
+            i = f[12] | (f[13] << 8);                   // OR mask
+            RefVal[MB_SPACE_HOLDING][addr] = (v & q) | (i & ~q);
+            memcpy(Ref_Header(e, f, 7)->Adu + 8, &f[8], 6);
+        }
+        return;
+
+    case 0x17:
+        waddr = Be16(&f[12]);
+        wq = Be16(&f[14]);
+        if ((q == 0) || (q > 125) || (wq == 0) || (wq > 121) || (f[16] != wq * 2) || (n != 11 + wq * 2))
+            Ref_Exception(e, f, 0x03);
+        else if ((Ref_Range(MB_SPACE_HOLDING, addr, q) < 0) ||
+                 ((r = Ref_Range(MB_SPACE_HOLDING, waddr, wq)) < 0) || !RefWritable[MB_SPACE_HOLDING][r])
+            Ref_Exception(e, f, 0x02);
+        else
+        {
+            for (i = 0; i < wq; i++)
+                RefVal[MB_SPACE_HOLDING][waddr + i] = f[17 + 2 * i] | (f[18 + 2 * i] << 8);
+            Ref_Read(Ref_Header(e, f, 2 + q * 2), MB_SPACE_HOLDING, addr, q);
+        }
+        return;
+    }
+}
+
+// Walks the stream as a Modbus TCP server must, the expected responses go to Exp
+static void Ref_Stream(const uint8_t *buf, uint32_t len)
+{
+    uint32_t pos = 0;
+    uint16_t n;
+    uint8_t hdr[8];
+    Expect *e;
+
+    ExpNum = 0;
+    Desync = 0;
+    while (len - pos >= 6)
+    {
+        n = Be16(&buf[pos + 4]);
+        if ((n < 2) || (n > TCP_ADU_MAX - 6))
+        {
+            memset(hdr, 0, sizeof(hdr));                // Unit id and function code as far as received
+            memcpy(hdr, &buf[pos], (len - pos < 8) ? len - pos : 8);
+            e = &Exp[ExpNum++];
+            e->Kind = EXP_BAD_MBAP;                     // Answered once 6 bytes are in, the rest
+            e->Done = 0;                                // may come in a later receive
+            Ref_Exception(e, hdr, 0x04);
+            Desync = 1;
+            return;
+        }
+        if (len - pos < 6u + n)
+            return;
+        Ref_Respond(&buf[pos], n);
+        pos += 6 + n;
+    }
+}
+
+/* Checks ------------------------------------------------------------------------------*/
+static int Fail(const char *what, const uint8_t *adu, uint16_t len)
+{
+    uint16_t i;
+
+    fprintf(stderr, "mb_fuzz: %s:", what);
+    for (i = 0; i < len; i++)
+        fprintf(stderr, " %02x", adu[i]);
+    fprintf(stderr, "\n");
+    return -1;
+}
+
+// The exception 04 for a bad MBAP length, the unit id and function code as far as
+// they were received when the firmware saw the length field, 0 from there on
+static int Bad_Match(const Expect *e, const uint8_t *a, uint16_t len)
+{
+    return (len == 9) && (memcmp(a, e->Adu, 6) == 0) && (a[8] == 0x04) &&
+           (((a[6] == e->Adu[6]) && (a[7] == e->Adu[7])) || ((a[6] == e->Adu[6]) && (a[7] == 0x80)) ||
+            ((a[6] == 0) && (a[7] == 0x80)));
+}
+
+// A response the gateway may give to request e
+static int Gw_Match(const Expect *e, const uint8_t *a, uint16_t len, uint8_t exceptions)
+{
+    if (e->Done || (memcmp(a, e->Adu, 4) != 0) || (a[6] != e->Adu[6]))
+        return 0;
+    if (!exceptions)
+        return (e->Kind == EXP_GW_ECHO) && (len == e->Len) && (memcmp(a + 7, e->Adu + 7, len - 7) == 0);
+    return (len == 9) && (a[7] == (e->Adu[7] | 0x80)) &&
+           ((a[8] == 0x06) || ((e->Kind == EXP_GW_FAIL) && (a[8] == 0x0B)));
+}
+
+static int Check(void)
+{
+    static uint32_t GwAdu[FRAME_MAX];
+    static uint16_t GwLen[FRAME_MAX];
+    uint32_t pos = 0, len;
+    uint16_t i, j, next = 0, gwnum = 0;
+    const uint8_t *a;
+    Expect *e;
+    uint8_t pass;
+
+    while (pos < OutLen)                                // Responses are whole ADUs
+    {
+        a = &Out[pos];
+        if ((OutLen - pos < 8) || (Be16(&a[4]) < 2) || (OutLen - pos < 6u + Be16(&a[4]))) // Unit + FC at least
+            return Fail("response framing", a, (OutLen - pos < 16) ? OutLen - pos : 16);
+        len = 6 + Be16(&a[4]);
+
+        if (Gw_Unit(a[6]))
+        {
+            GwAdu[gwnum] = pos;                         // Matched below, they come in any order
+            GwLen[gwnum++] = len;
+            pos += len;
+            continue;
+        }
+
+        while ((next < ExpNum) && !Local_Exp(&Exp[next]))
+            next++;
+        if (next == ExpNum)
+        {
+            if (!Desync)
+                return Fail("response without a request", a, len);
+            pos += len;
+            continue;
+        }
+
+        e = &Exp[next++];
+        e->Done = 1;
+        if (e->Kind == EXP_DEVID)
+        {
+            if ((memcmp(a, e->Adu, 4) != 0) || (a[6] != e->Adu[6]) ||
+                !(((a[7] == 0x2B) && (len >= 9) && (a[8] == 0x0E)) ||
+                  ((a[7] == 0xAB) && (len == 9) && ((a[8] == 0x02) || (a[8] == 0x03)))))
+                return Fail("FC43 response", a, len);
+        }
+        else if (e->Kind == EXP_CHANGES)
+        {
+            if ((memcmp(a, e->Adu, 4) != 0) || (a[6] != e->Adu[6]) || (a[7] != 0x41) || (len < 14) ||
+                (a[8] != len - 9) || ((a[8] - 5) % 9 != 0) || ((a[8] - 5) / 9 > e->Adu[12]) || (a[13] > 2))
+                return Fail("FC65 response", a, len);
+        }
+        else if (e->Kind == EXP_BAD_MBAP)
+        {
+            if (!Bad_Match(e, a, len))
+            {
+                e->Done = 0;                            // Out of sync, or answered with its gateway
+                next--;                                 // unit id, checked below
+            }
+        }
+        else if ((len != e->Len) || (memcmp(a, e->Adu, len) != 0))
+        {
+            Fail("expected", e->Adu, e->Len);
+            return Fail("response", a, len);
+        }
+        pos += len;
+    }
+
+    for (i = 0; i < ExpNum; i++)                         // Every request answered
+    {
+        if (!Exp[i].Done && Local_Exp(&Exp[i]) && ((Exp[i].Kind != EXP_BAD_MBAP) || !Gw_Unit(Exp[i].Adu[6])))
+            return Fail("request without a response", Exp[i].Adu, Exp[i].Len);
+    }
+
+    for (pass = 0; pass < 2; pass++)                     // Echoes first, then exceptions
+    {
+        for (j = 0; j < gwnum; j++)
+        {
+            if (GwLen[j] == 0)
+                continue;
+            a = &Out[GwAdu[j]];
+            for (i = 0; i < ExpNum; i++)
+            {
+                if ((Exp[i].Kind == EXP_EXACT) && !Exp[i].Done && (GwLen[j] == Exp[i].Len) &&
+                    (memcmp(a, Exp[i].Adu, GwLen[j]) == 0))
+                    break;                               // Exception 04 for a gateway unit id
+                if ((Exp[i].Kind == EXP_BAD_MBAP) && !Exp[i].Done && Bad_Match(&Exp[i], a, GwLen[j]))
+                    break;
+                if ((Exp[i].Kind >= EXP_GW_ECHO) && Gw_Match(&Exp[i], a, GwLen[j], pass))
+                    break;
+            }
+            if (i < ExpNum)
+            {
+                Exp[i].Done = 1;
+                GwLen[j] = 0;
+            }
+        }
+    }
+    for (j = 0; j < gwnum; j++)
+    {
+        if (GwLen[j] && !Desync)
+            return Fail("gateway response without a request", &Out[GwAdu[j]], GwLen[j]);
+    }
+    for (i = 0; i < ExpNum; i++)
+    {
+        if (!Exp[i].Done)
+            return Fail("gateway request without a response", Exp[i].Adu, Exp[i].Len);
+    }
+
+    return Desync ? 0 : Ref_Compare();
+}
+
+/* Driver ------------------------------------------------------------------------------*/
+static void Receive(const uint8_t *buf, uint32_t len)
+{
+    uint8_t i, n;
+
+    RxOff = sizeof(RxBuf) - len;                        // The receive ends where the buffer ends
+    memcpy(&RxBuf[RxOff], buf, len);
+    RxFreed = 0;
+    MB_TCP_Receive(0);
+    if (RxFreed != len)
+    {
+        fprintf(stderr, "mb_fuzz: %u of %u received bytes freed\n", RxFreed, len);
+        abort();
+    }
+
+    n = SubNum;                                         // Downstream responses, MB_GW_Done may queue more
+    SubNum = 0;
+    for (i = 0; i < n; i++)
+        MB_GW_Done(SubTag[i], SubPdu[i], SubLen[i]);
+}
+
+#ifndef MB_FUZZ_LIBFUZZER
+static void Save_Input(const uint8_t *data, size_t size);
+#endif
+
+static int Run(const uint8_t *data, size_t size)
+{
+    uint32_t pos = 0, n, seed, x;
+
+    if ((size < 1) || (size > INPUT_MAX))
+        return 0;
+    seed = data[0];
+    data++;
+    size--;
+
+    Ref_Reset();
+    Ref_Stream(data, size);
+
+    MB_Session_Open(0);
+    SubNum = 0;
+    OutLen = 0;
+    x = seed * 0x9E3779B1u + 1;
+    while (pos < size)
+    {
+        n = (seed == 0) ? size - pos : 1 + Xorshift(&x) % (4 * seed);
+        if (n > size - pos)
+            n = size - pos;
+        Receive(data + pos, n);
+        pos += n;
+    }
+    MB_Session_Close(0);
+
+    if (Check() != 0)
+    {
+#ifndef MB_FUZZ_LIBFUZZER
+        Save_Input(data - 1, size + 1);                 // libFuzzer saves it itself
+#endif
+        abort();
+    }
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    return Run(data, size);
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    static const uint8_t mac[6] = { 0x84, 0xC2, 0xE4, 0x01, 0x02, 0x03 };
+
+    (void) argc; (void) argv;
+    if (freopen("/dev/null", "w", stdout) == NULL)     // The handlers print, keep the fuzzer output readable
+        return 0;
+    MB_DevId_Init(0x30700518, mac);
+    if (MB_Map_Check() != 0)
+    {
+        fprintf(stderr, "mb_fuzz: test register map rejected by MB_Map_Check\n");
+        exit(1);
+    }
+    return 0;
+}
+
+#ifndef MB_FUZZ_LIBFUZZER
+
+#define FAILURE_FILE       "mb_fuzz-failure.bin"
+
+static uint8_t Input[INPUT_MAX];
+static FILE *Report;                                    // Results, stdout is the handlers' debug output
+
+/* Generated requests, biased to the edges of the map and of the limits ---------------*/
+static uint16_t Gen_Addr(uint8_t space)
+{
+    const MB_Region *r = &MB_Map[space].Regions[Rand32() % MB_Map[space].Num];
+
+    switch (Rand32() % 6)
+    {
+    case 0:  return r->Start - 1;
+    case 1:  return r->Start;
+    case 2:  return r->Start + r->Count - 1 - Rand32() % 40;
+    case 3:  return r->Start + r->Count;
+    case 4:  return Rand32();
+    default: return r->Start + Rand32() % r->Count;
+    }
+}
+
+static uint16_t Gen_Qty(uint16_t max)
+{
+    static const uint16_t edge[] = { 0, 1, 2, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65 };
+
+    switch (Rand32() % 4)
+    {
+    case 0:  return edge[Rand32() % (sizeof(edge) / sizeof(edge[0]))];
+    case 1:  return max + (Rand32() % 3) - 1;
+    case 2:  return Rand32();
+    default: return 1 + Rand32() % max;
+    }
+}
+
+static uint16_t Gen_Request(uint8_t *f)
+{
+    static const uint8_t fcs[] = { 1, 2, 3, 4, 5, 6, 15, 16, 22, 23, 43, 65, 7, 0x81, 0 };
+    static const uint8_t units[] = { 1, 255, 0, 20, 247, 2, 5, 9, 10, 19 };
+    uint8_t fc = fcs[Rand32() % sizeof(fcs)];
+    uint16_t n = 6, q, bc, i;
+
+    memset(f, 0, TCP_ADU_MAX);
+    f[0] = Rand32();
+    f[1] = Rand32();
+    f[2] = (Rand32() % 16 == 0) ? Rand32() : 0;          // Protocol identifier, ignored
+    f[6] = units[Rand32() % sizeof(units)];
+    f[7] = fc;
+
+    switch (fc)
+    {
+    case 1: case 2: case 3: case 4:
+        q = Gen_Qty((fc <= 2) ? 2000 : 125);
+        break;
+    case 15: case 16: case 23:
+        q = Gen_Qty((fc == 15) ? 1968 : (fc == 16) ? 123 : 121);
+        break;
+    default:
+        q = Rand32();
+        break;
+    }
+
+    switch (fc)
+    {
+    case 1: case 2: case 3: case 4: case 5: case 6: case 15: case 16: case 22:
+    {
+        uint16_t a = Gen_Addr((fc == 1) || (fc == 5) || (fc == 15) ? MB_SPACE_COILS :
+                              (fc == 2) ? MB_SPACE_DISCRETE : (fc == 4) ? MB_SPACE_INPUT : MB_SPACE_HOLDING);
+        f[8] = a >> 8;
+        f[9] = a;
+        break;
+    }
+    case 23:
+    {
+        uint16_t a = Gen_Addr(MB_SPACE_HOLDING), w = Gen_Addr(MB_SPACE_HOLDING), rq = Gen_Qty(125);
+        f[8] = a >> 8;  f[9] = a;  f[10] = rq >> 8;  f[11] = rq;
+        f[12] = w >> 8; f[13] = w; f[14] = q >> 8;   f[15] = q;
+        bc = (q * 2 > 242) ? Rand32() % 243 : q * 2;
+        if (Rand32() % 8 == 0)
+            bc += (Rand32() % 3) - 1;
+        f[16] = bc;
+        for (i = 0; (i < bc) && (17 + i < TCP_ADU_MAX); i++)
+            f[17 + i] = Rand32();
+        n = 11 + (bc & 0xFF);
+        if (n > 254)
+            n = 254;
+        break;
+    }
+    case 43:
+        f[8] = (Rand32() % 8) ? 0x0E : Rand32();
+        f[9] = 1 + Rand32() % 5;
+        f[10] = Rand32() % 8 ? Rand32() % 6 : 0x80 + Rand32() % 3;
+        n = 5;
+        break;
+    case 65:
+        f[8] = Rand32() % 2 ? 0xFF : 0;
+        f[12] = Gen_Qty(TCP_CHANGES_MAX);
+        n = 7;
+        break;
+    default:
+        for (i = 8; i < 14; i++)
+            f[i] = Rand32();
+        n = 2 + Rand32() % 8;
+        break;
+    }
+
+    switch (fc)
+    {
+    case 1: case 2: case 3: case 4: case 6: case 22:
+        f[10] = q >> 8;
+        f[11] = q;
+        if (fc == 6)
+            f[10] = Rand32(), f[11] = Rand32();
+        if (fc == 22)
+        {
+            for (i = 10; i < 14; i++)
+                f[i] = Rand32();
+            n = 8;
+        }
+        break;
+    case 5:
+        q = (Rand32() % 4 == 0) ? Rand32() : (Rand32() % 2) ? 0xFF00 : 0;
+        f[10] = q >> 8;
+        f[11] = q;
+        break;
+    case 15: case 16:
+        f[10] = q >> 8;
+        f[11] = q;
+        bc = (fc == 15) ? (q + 7) / 8 : q * 2;
+        if ((bc > 246) || (Rand32() % 8 == 0))
+            bc = (bc > 246) ? Rand32() % 247 : bc + (Rand32() % 3) - 1; // Byte count off by one
+        if (bc > 246)
+            bc = 246;                                   // 0 - 1 wrapped
+        f[12] = bc;
+        for (i = 0; i < bc; i++)
+            f[13 + i] = Rand32();
+        n = 7 + (bc & 0xFF);
+        if (n > 254)
+            n = 254;
+        break;
+    }
+
+    if (Rand32() % 64 == 0)
+        n += (Rand32() % 3) - 1;                        // Length field off by one
+    if (Rand32() % 512 == 0)
+        n = Rand32() % 2 ? Rand32() % 2 : 255 + Rand32() % 8; // Not a Modbus ADU at all
+    f[4] = n >> 8;
+    f[5] = n;
+    return 6 + ((n <= 254) ? n : 0);
+}
+
+static int Generate(uint32_t count)
+{
+    uint32_t k, size;
+    uint16_t len;
+    uint8_t f[TCP_ADU_MAX];
+
+    for (k = 0; k < count; k++)
+    {
+        Input[0] = (Rand32() % 3 == 0) ? 0 : Rand32() % 80;
+        size = 1;
+        do
+        {
+            len = Gen_Request(f);
+            if (size + len > sizeof(Input))
+                break;
+            memcpy(&Input[size], f, len);
+            size += len;
+        } while (Rand32() % 8);
+        if (Rand32() % 16 == 0)
+            size -= Rand32() % size;                    // Cut off in the middle of an ADU
+        Run(Input, size);
+    }
+    fprintf(Report, "generated: %u streams\n", count);
+    return 0;
+}
+
+/* Conformance suite -------------------------------------------------------------------*/
+static uint32_t Conform_Run(const uint8_t *f, uint16_t len, uint8_t chunk)
+{
+    Input[0] = chunk;
+    memcpy(&Input[1], f, len);
+    Run(Input, 1 + len);
+    return 1;
+}
+
+static uint16_t Conform_Adu(uint8_t *f, uint8_t fc, uint16_t addr, uint16_t q)
+{
+    uint16_t i, bc = 0, n = 6;
+
+    f[0] = addr >> 8; f[1] = q;
+    f[2] = 0;         f[3] = 0;
+    f[6] = 1;         f[7] = fc;
+    f[8] = addr >> 8; f[9] = addr;
+    f[10] = q >> 8;   f[11] = q;
+    if (fc == 0x0F)
+    {
+        bc = (q + 7) / 8;
+        f[12] = bc;
+        for (i = 0; i < bc; i++)
+            f[13 + i] = Rand32();
+        n = 7 + bc;
+    }
+    f[4] = n >> 8;
+    f[5] = n;
+    return 6 + n;
+}
+
+// FC01, FC02 and FC15 at every alignment round each region start and end, each write
+// read back in the same stream, FC05 with every kind of value
+static int Conform(void)
+{
+    static const uint16_t qty[] = { 0, 1, 2, 7, 8, 9, 15, 16, 17, 24, 31, 32, 33, 40, 63, 64, 65,
+                                    96, 255, 256, 257, 1968, 1969, 2000, 2001 };
+    uint8_t f[2 * TCP_ADU_MAX], space;
+    uint32_t cases = 0;
+    uint16_t i, q, len, edge;
+    int32_t a;
+
+    for (space = MB_SPACE_COILS; space <= MB_SPACE_DISCRETE; space++)
+    {
+        for (i = 0; i < MB_Map[space].Num; i++)
+        {
+            for (edge = 0; edge < 2; edge++)
+            {
+                const MB_Region *r = &MB_Map[space].Regions[i];
+                int32_t base = edge ? r->Start + r->Count : r->Start;
+
+                for (a = base - 40; a <= base + 40; a++)
+                {
+                    if ((a < 0) || (a > 0xFFFF))
+                        continue;
+                    for (q = 0; q < sizeof(qty) / sizeof(qty[0]); q++)
+                    {
+                        cases += Conform_Run(f, Conform_Adu(f, space == MB_SPACE_COILS ? 0x01 : 0x02, a, qty[q]), 0);
+                        if (space != MB_SPACE_COILS)
+                            continue;
+                        if (qty[q] > 1968)
+                            continue;
+                        len = Conform_Adu(f, 0x0F, a, qty[q]);
+                        len += Conform_Adu(f + len, 0x01, a, qty[q] ? qty[q] : 1);
+                        cases += Conform_Run(f, len, 0);
+                        cases += Conform_Run(f, len, 1);  // One to four bytes per receive
+                    }
+                }
+            }
+        }
+    }
+
+    for (a = 0; a < 0x10000; a += 0x100)                // FC05 values
+    {
+        len = Conform_Adu(f, 0x05, Rand32() % 300, 0);
+        f[10] = a >> 8;
+        f[11] = Rand32();
+        if (a == 0xFF00) f[11] = 0;
+        cases += Conform_Run(f, len, 0);
+        f[11] = 0;
+        cases += Conform_Run(f, len, 0);
+    }
+
+    fprintf(Report, "conformance: %u cases\n", cases);
+    return 0;
+}
+
+// The input of a failed run, to replay it with build/mb_fuzz FAILURE_FILE
+static void Save_Input(const uint8_t *data, size_t size)
+{
+    FILE *fp = fopen(FAILURE_FILE, "wb");
+
+    if ((fp == NULL) || (fwrite(data, 1, size, fp) != size) || (fclose(fp) != 0))
+        perror(FAILURE_FILE);
+    else
+        fprintf(stderr, "mb_fuzz: input saved to %s\n", FAILURE_FILE);
+}
+
+static uint32_t Read_File(FILE *fp)
+{
+    return fread(Input, 1, sizeof(Input), fp);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t count = 0, size;
+    int opt, conform = 0, i;
+    FILE *fp;
+
+    while ((opt = getopt(argc, argv, "cn:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c': conform = 1; break;
+        case 'n': count = strtoul(optarg, NULL, 0); break;
+        case 's': RandState = strtoul(optarg, NULL, 0) | 1; break;
+        default:
+            fprintf(stderr, "usage: %s [-c] [-n streams] [-s seed] [file ...]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    setvbuf(stderr, NULL, _IONBF, 0);
+    i = dup(1);                                         // Results go to the real stdout
+    LLVMFuzzerInitialize(&argc, &argv);
+    if ((i < 0) || (Report = fdopen(i, "w")) == NULL)
+        return 1;
+
+    if (conform)
+        Conform();
+    if (count)
+        Generate(count);
+
+    for (i = optind; i < argc; i++)
+    {
+        if ((fp = fopen(argv[i], "rb")) == NULL)
+        {
+            perror(argv[i]);
+            return 1;
+        }
+        size = Read_File(fp);
+        fclose(fp);
+        Run(Input, size);
+    }
+    if (!conform && !count && (optind == argc))
+        Run(Input, Read_File(stdin));
+    return 0;
+}
+
+#endif
@@ -0,0 +1,312 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : ch32v30x.h
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Host (Linux) stand-in for the CH32V30x device header.
+ *                      Only the types, registers and peripheral calls used by
+ *                      the application sources are provided, the peripherals
+ *                      themselves are emulated in ch32v30x_host.c.
+*********************************************************************************/
+
+#ifndef __CH32V30x_H
+#define __CH32V30x_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#define __IO volatile
+
+typedef __IO uint64_t  vu64;
+typedef __IO uint32_t  vu32;
+typedef __IO uint16_t  vu16;
+typedef __IO uint8_t   vu8;
+
+typedef uint32_t  u32;
+typedef uint16_t  u16;
+typedef uint8_t   u8;
+
+typedef enum {RESET = 0, SET = !RESET} FlagStatus, ITStatus;
+typedef enum {DISABLE = 0, ENABLE = !DISABLE} FunctionalState;
+
+/* Interrupt Number Definition */
+typedef enum IRQn
+{
+  SysTicK_IRQn                = 12,
+  EXTI3_IRQn                  = 26,
+  TIM2_IRQn                   = 44,
+} IRQn_Type;
+
+/* Peripheral registers */
+typedef struct
+{
+  __IO uint32_t CFGLR;
+  __IO uint32_t CFGHR;
+  __IO uint32_t INDR;
+  __IO uint32_t OUTDR;
+  __IO uint32_t BSHR;
+  __IO uint32_t BCR;
+  __IO uint32_t LCKR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  __IO uint32_t CTLR;
+  __IO uint32_t SR;
+  __IO uint64_t CNT;
+  __IO uint64_t CMP;
+} SysTick_Type;
+
+typedef struct
+{
+  __IO uint16_t STATR;
+  __IO uint16_t DATAR;
+} USART_TypeDef;
+
+typedef struct
+{
+  __IO uint16_t CTLR1;
+  __IO uint16_t INTFR;
+  __IO uint16_t CNT;
+} TIM_TypeDef;
+
+typedef struct
+{
+  __IO uint32_t CFGR;
+  __IO uint32_t CNTR;
+  __IO uint32_t PADDR;
+  __IO uint32_t MADDR;
+} DMA_Channel_TypeDef;
+
+extern GPIO_TypeDef  HOST_GPIOA, HOST_GPIOB;
+extern SysTick_Type  HOST_SysTick;
+extern USART_TypeDef HOST_USART2;
+extern TIM_TypeDef   HOST_TIM2;
+extern DMA_Channel_TypeDef HOST_DMA1_Channel6, HOST_DMA1_Channel7;
+
+#define GPIOA        (&HOST_GPIOA)
+#define GPIOB        (&HOST_GPIOB)
+#define SysTick      (&HOST_SysTick)
+#define USART2       (&HOST_USART2)
+#define TIM2         (&HOST_TIM2)
+#define DMA1_Channel6 (&HOST_DMA1_Channel6)
+#define DMA1_Channel7 (&HOST_DMA1_Channel7)
+
+extern uint32_t SystemCoreClock;
+
+/* RCC */
+#define RCC_APB2Periph_AFIO              ((uint32_t)0x00000001)
+#define RCC_APB2Periph_GPIOA             ((uint32_t)0x00000004)
+#define RCC_APB2Periph_GPIOB             ((uint32_t)0x00000008)
+#define RCC_APB1Periph_TIM2              ((uint32_t)0x00000001)
+#define RCC_APB1Periph_USART2            ((uint32_t)0x00020000)
+#define RCC_AHBPeriph_DMA1               ((uint32_t)0x00000001)
+
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState);
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState);
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState);
+
+/* GPIO */
+#define GPIO_Pin_1                       ((uint16_t)0x0002)
+#define GPIO_Pin_2                       ((uint16_t)0x0004)
+#define GPIO_Pin_3                       ((uint16_t)0x0008)
+#define GPIO_Pin_4                       ((uint16_t)0x0010)
+#define GPIO_Pin_15                      ((uint16_t)0x8000)
+
+#define GPIO_PortSourceGPIOB             ((uint8_t)0x01)
+#define GPIO_PinSource3                  ((uint8_t)0x03)
+
+typedef enum
+{
+  GPIO_Speed_10MHz = 1,
+  GPIO_Speed_2MHz,
+  GPIO_Speed_50MHz
+} GPIOSpeed_TypeDef;
+
+typedef enum
+{
+  GPIO_Mode_AIN = 0x0,
+  GPIO_Mode_IN_FLOATING = 0x04,
+  GPIO_Mode_IPD = 0x28,
+  GPIO_Mode_IPU = 0x48,
+  GPIO_Mode_Out_OD = 0x14,
+  GPIO_Mode_Out_PP = 0x10,
+  GPIO_Mode_AF_OD = 0x1C,
+  GPIO_Mode_AF_PP = 0x18
+} GPIOMode_TypeDef;
+
+typedef struct
+{
+  uint16_t GPIO_Pin;
+  GPIOSpeed_TypeDef GPIO_Speed;
+  GPIOMode_TypeDef GPIO_Mode;
+} GPIO_InitTypeDef;
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct);
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void GPIO_SetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void GPIO_ResetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void GPIO_EXTILineConfig(uint8_t GPIO_PortSource, uint8_t GPIO_PinSource);
+
+/* EXTI */
+#define EXTI_Line3                       ((uint32_t)0x00008)
+
+typedef enum
+{
+  EXTI_Mode_Interrupt = 0x00,
+  EXTI_Mode_Event = 0x04
+} EXTIMode_TypeDef;
+
+typedef enum
+{
+  EXTI_Trigger_Rising = 0x08,
+  EXTI_Trigger_Falling = 0x0C,
+  EXTI_Trigger_Rising_Falling = 0x10
+} EXTITrigger_TypeDef;
+
+typedef struct
+{
+  uint32_t EXTI_Line;
+  EXTIMode_TypeDef EXTI_Mode;
+  EXTITrigger_TypeDef EXTI_Trigger;
+  FunctionalState EXTI_LineCmd;
+} EXTI_InitTypeDef;
+
+void EXTI_Init(EXTI_InitTypeDef *EXTI_InitStruct);
+
+/* NVIC */
+typedef struct
+{
+  uint8_t NVIC_IRQChannel;
+  uint8_t NVIC_IRQChannelPreemptionPriority;
+  uint8_t NVIC_IRQChannelSubPriority;
+  FunctionalState NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct);
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+void NVIC_SetPriority(IRQn_Type IRQn, uint8_t priority);
+
+/* TIM */
+#define TIM_CounterMode_Up               ((uint16_t)0x0000)
+#define TIM_IT_Update                    ((uint16_t)0x0001)
+
+typedef struct
+{
+  uint16_t TIM_Prescaler;
+  uint16_t TIM_CounterMode;
+  uint16_t TIM_Period;
+  uint16_t TIM_ClockDivision;
+  uint8_t TIM_RepetitionCounter;
+} TIM_TimeBaseInitTypeDef;
+
+void TIM_TimeBaseInit(TIM_TypeDef *TIMx, TIM_TimeBaseInitTypeDef *TIM_TimeBaseInitStruct);
+void TIM_ITConfig(TIM_TypeDef *TIMx, uint16_t TIM_IT, FunctionalState NewState);
+void TIM_Cmd(TIM_TypeDef *TIMx, FunctionalState NewState);
+void TIM_ClearITPendingBit(TIM_TypeDef *TIMx, uint16_t TIM_IT);
+
+/* USART */
+#define USART_WordLength_8b              ((uint16_t)0x0000)
+#define USART_StopBits_1                 ((uint16_t)0x0000)
+#define USART_Parity_No                  ((uint16_t)0x0000)
+#define USART_Mode_Rx                    ((uint16_t)0x0004)
+#define USART_Mode_Tx                    ((uint16_t)0x0008)
+#define USART_HardwareFlowControl_None   ((uint16_t)0x0000)
+#define USART_DMAReq_Tx                  ((uint16_t)0x0080)
+#define USART_DMAReq_Rx                  ((uint16_t)0x0040)
+#define USART_FLAG_TC                    ((uint16_t)0x0040)
+#define USART_FLAG_RXNE                  ((uint16_t)0x0020)
+#define USART_FLAG_ORE                   ((uint16_t)0x0008)
+
+typedef struct
+{
+  uint32_t USART_BaudRate;
+  uint16_t USART_WordLength;
+  uint16_t USART_StopBits;
+  uint16_t USART_Parity;
+  uint16_t USART_Mode;
+  uint16_t USART_HardwareFlowControl;
+} USART_InitTypeDef;
+
+void USART_Init(USART_TypeDef *USARTx, USART_InitTypeDef *USART_InitStruct);
+void USART_Cmd(USART_TypeDef *USARTx, FunctionalState NewState);
+void USART_DMACmd(USART_TypeDef *USARTx, uint16_t USART_DMAReq, FunctionalState NewState);
+void USART_SendData(USART_TypeDef *USARTx, uint16_t Data);
+uint16_t USART_ReceiveData(USART_TypeDef *USARTx);
+FlagStatus USART_GetFlagStatus(USART_TypeDef *USARTx, uint16_t USART_FLAG);
+void USART_ClearFlag(USART_TypeDef *USARTx, uint16_t USART_FLAG);
+
+/* DMA */
+#define DMA_DIR_PeripheralDST            ((uint32_t)0x00000010)
+#define DMA_DIR_PeripheralSRC            ((uint32_t)0x00000000)
+#define DMA_PeripheralInc_Disable        ((uint32_t)0x00000000)
+#define DMA_MemoryInc_Enable             ((uint32_t)0x00000080)
+#define DMA_PeripheralDataSize_Byte      ((uint32_t)0x00000000)
+#define DMA_MemoryDataSize_Byte          ((uint32_t)0x00000000)
+#define DMA_Mode_Normal                  ((uint32_t)0x00000000)
+#define DMA_Priority_Medium              ((uint32_t)0x00001000)
+#define DMA_M2M_Disable                  ((uint32_t)0x00000000)
+#define DMA1_FLAG_TC7                    ((uint32_t)0x02000000)
+
+typedef struct
+{
+  uint32_t DMA_PeripheralBaseAddr;
+  uint32_t DMA_MemoryBaseAddr;
+  uint32_t DMA_DIR;
+  uint32_t DMA_BufferSize;
+  uint32_t DMA_PeripheralInc;
+  uint32_t DMA_MemoryInc;
+  uint32_t DMA_PeripheralDataSize;
+  uint32_t DMA_MemoryDataSize;
+  uint32_t DMA_Mode;
+  uint32_t DMA_Priority;
+  uint32_t DMA_M2M;
+} DMA_InitTypeDef;
+
+void DMA_DeInit(DMA_Channel_TypeDef *DMAy_Channelx);
+void DMA_Init(DMA_Channel_TypeDef *DMAy_Channelx, DMA_InitTypeDef *DMA_InitStruct);
+void DMA_Cmd(DMA_Channel_TypeDef *DMAy_Channelx, FunctionalState NewState);
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef *DMAy_Channelx, uint16_t DataNumber);
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef *DMAy_Channelx);
+FlagStatus DMA_GetFlagStatus(uint32_t DMAy_FLAG);
+void DMA_ClearFlag(uint32_t DMAy_FLAG);
+
+/* FLASH */
+typedef enum
+{
+  FLASH_BUSY = 1,
+  FLASH_ERROR_PG,
+  FLASH_ERROR_WRP,
+  FLASH_COMPLETE,
+  FLASH_TIMEOUT,
+  FLASH_OP_RANGE_ERROR = 0xFD,
+  FLASH_ALIGN_ERROR = 0xFE,
+  FLASH_ADR_RANGE_ERROR = 0xFF,
+} FLASH_Status;
+
+void FLASH_Unlock(void);
+void FLASH_Lock(void);
+void FLASH_Unlock_Fast(void);
+void FLASH_Lock_Fast(void);
+void FLASH_ErasePage_Fast(uint32_t Page_Address);
+FLASH_Status FLASH_ProgramWord(uint32_t Address, uint32_t Data);
+
+/* ETH */
+#define PHY_Linked_Status                ((uint16_t)0x0004)
+
+/* DBGMCU */
+uint32_t DBGMCU_GetCHIPID(void);
+
+/* System */
+void SystemCoreClockUpdate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V30x_H */
@@ -0,0 +1,29 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : debug.h
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Host (Linux) stand-in for Debug/debug.h, printf goes
+ *                      to stdout instead of USART1.
+*********************************************************************************/
+#ifndef __DEBUG_H
+#define __DEBUG_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "stdio.h"
+#include "ch32v30x.h"
+
+void Delay_Init(void);
+void Delay_Us (uint32_t n);
+void Delay_Ms (uint32_t n);
+void USART_Printf_Init(uint32_t baudrate);
+void SDI_Printf_Enable(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
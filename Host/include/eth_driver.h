@@ -0,0 +1,35 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : eth_driver.h
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Host (Linux) stand-in for NetLib/eth_driver.h. The ETH
+ *                      MAC/PHY driver is replaced by wchnet_host.c, which
+ *                      implements the WCHNET socket API on POSIX TCP sockets.
+*********************************************************************************/
+#ifndef __ETH_DRIVER__
+#define __ETH_DRIVER__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "debug.h"
+#include "wchnet.h"
+
+#ifndef WCHNETTIMERPERIOD
+#define WCHNETTIMERPERIOD                       10   /* Timer period, in Ms. */
+#endif
+
+extern SOCK_INF SocketInf[ ];
+extern volatile uint32_t LocalTime;
+
+void WCHNET_MainTask( void );
+void WCHNET_TimeIsr( uint16_t timperiod );
+uint8_t ETH_LibInit( uint8_t *ip, uint8_t *gwip, uint8_t *mask, uint8_t *macaddr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
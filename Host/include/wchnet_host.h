@@ -0,0 +1,25 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : wchnet_host.h
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Host (Linux) WCHNET shim counters.
+*********************************************************************************/
+#ifndef __WCHNET_HOST_H__
+#define __WCHNET_HOST_H__
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t Connects;                        // Accepted connections
+    uint32_t Closes;                          // Connections closed by the application
+    uint32_t RxSegments;                      // recv() calls that returned data
+    uint32_t TxSegments;                      // WCHNET_SocketSend calls, one segment each
+    uint64_t RxBytes;                         // Payload bytes received
+    uint64_t TxBytes;                         // Payload bytes sent
+} WCHNET_HostStats;
+
+extern WCHNET_HostStats HostStats;
+
+#endif
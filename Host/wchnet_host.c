@@ -0,0 +1,468 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : wchnet_host.c
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Host (Linux) implementation of the WCHNET socket API on
+ *                      top of POSIX TCP sockets, so the request handlers from
+ *                      User/main.c run unchanged on a PC.
+*********************************************************************************/
+
+/*
+    Semantics follow libwchnet.a as it is used by this project:
+
+      * a listening socket keeps its id, every accepted connection gets the
+        lowest free id, inherits the listen port in SourPort and raises
+        SINT_STAT_CONNECT;
+      * received bytes are appended to the buffer given by WCHNET_ModifyRecvBuf,
+        WCHNET_SocketRecvLen returns the unread length (and the read address),
+        WCHNET_SocketRecv copies out and consumes, or only consumes when buf
+        is NULL;
+      * a peer close raises SINT_STAT_DISCONNECT, the id is released after the
+        interrupt has been read by the application.
+
+    Buffer addresses are passed as uint32_t by the WCHNET API, so the host
+    binary must be linked as a non-PIE executable (see Makefile), where all
+    static buffers live below 4 GB.
+
+    Environment:
+      WCHNET_PORT_OFFSET - added to every listen port, e.g. 10000 serves
+                           HTTP on 10080 and Modbus on 10502 without root.
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "eth_driver.h"
+#include "wchnet_host.h"
+
+#define HOST_POLL_TIMEOUT_MS    1   // Upper bound of one WCHNET_MainTask wait
+
+typedef struct
+{
+    int fd;                         // POSIX socket, -1 when the id is free
+    uint8_t listening;              // 1: listen socket, 0: connection
+    uint8_t release;                // Peer gone, free the id once the interrupt is read
+} HostSock;
+
+SOCK_INF SocketInf[WCHNET_MAX_SOCKET_NUM];
+volatile uint32_t LocalTime;
+
+WCHNET_HostStats HostStats;
+
+static HostSock HostSocks[WCHNET_MAX_SOCKET_NUM];
+static uint8_t GlobIntStatus;
+static uint16_t PortOffset;
+static const uint8_t HostMacAddr[6] = {0x02, 0x00, 0x00, 0x30, 0x73, 0x07};
+
+/*********************************************************************
+ * @fn      Host_AllocId
+ *
+ * @brief   Find the lowest free socket id.
+ *
+ * @return  socket id, or WCHNET_MAX_SOCKET_NUM if none is free
+ */
+static uint8_t Host_AllocId(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < WCHNET_MAX_SOCKET_NUM; i++)
+        if (HostSocks[i].fd < 0) break;
+    return i;
+}
+
+/*********************************************************************
+ * @fn      Host_FreeId
+ *
+ * @brief   Close the POSIX socket and release the id.
+ *
+ * @return  none
+ */
+static void Host_FreeId(uint8_t id)
+{
+    if (HostSocks[id].fd >= 0) close(HostSocks[id].fd);
+    HostSocks[id].fd = -1;
+    HostSocks[id].listening = 0;
+    HostSocks[id].release = 0;
+    memset(&SocketInf[id], 0, sizeof(SOCK_INF));
+}
+
+/*********************************************************************
+ * @fn      Host_ConnCount
+ *
+ * @brief   Number of ids currently holding a TCP connection.
+ *
+ * @return  count
+ */
+static uint8_t Host_ConnCount(void)
+{
+    uint8_t i, n = 0;
+
+    for (i = 0; i < WCHNET_MAX_SOCKET_NUM; i++)
+        if (HostSocks[i].fd >= 0 && !HostSocks[i].listening) n++;
+    return n;
+}
+
+/*********************************************************************
+ * @fn      Host_Raise
+ *
+ * @brief   Raise a socket interrupt.
+ *
+ * @return  none
+ */
+static void Host_Raise(uint8_t id, uint8_t intstat)
+{
+    SocketInf[id].IntStatus |= intstat;
+    GlobIntStatus |= GINT_STAT_SOCKET;
+}
+
+/*********************************************************************
+ * @fn      Host_Accept
+ *
+ * @brief   Accept a pending connection on a listen socket.
+ *
+ * @return  none
+ */
+static void Host_Accept(uint8_t lid)
+{
+    struct sockaddr_in peer;
+    socklen_t plen = sizeof(peer);
+    uint8_t id;
+    int fd, one = 1;
+
+    fd = accept(HostSocks[lid].fd, (struct sockaddr *) &peer, &plen);
+    if (fd < 0) return;
+
+    id = Host_AllocId();
+    if (id >= WCHNET_MAX_SOCKET_NUM) {
+        close(fd);
+        return;
+    }
+    // One WCHNET_SocketSend is one TCP segment on the board
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    HostSocks[id].fd = fd;
+    HostSocks[id].listening = 0;
+    HostSocks[id].release = 0;
+    memset(&SocketInf[id], 0, sizeof(SOCK_INF));
+    SocketInf[id].SockIndex = id;
+    SocketInf[id].ProtoType = PROTO_TYPE_TCP;
+    SocketInf[id].SockStatus = SOCK_STAT_OPEN | (TCP_ESTABLISHED << 8);
+    SocketInf[id].SourPort = SocketInf[lid].SourPort;
+    SocketInf[id].DesPort = ntohs(peer.sin_port);
+    memcpy(SocketInf[id].IPAddr, &peer.sin_addr.s_addr, 4);
+    HostStats.Connects++;
+    Host_Raise(id, SINT_STAT_CONNECT);
+}
+
+/*********************************************************************
+ * @fn      Host_Receive
+ *
+ * @brief   Append received bytes to the socket receive buffer.
+ *
+ * @return  none
+ */
+static void Host_Receive(uint8_t id)
+{
+    SOCK_INF *s = &SocketInf[id];
+    uint32_t room;
+    ssize_t n;
+
+    if (s->RecvRemLen == 0)
+        s->RecvReadPoint = s->RecvCurPoint = s->RecvStartPoint;
+    room = s->RecvStartPoint + s->RecvBufLen - s->RecvCurPoint;
+    if (room == 0 && s->RecvReadPoint != s->RecvStartPoint) {
+        // Move the unread tail to the start of the buffer
+        memmove((uint8_t *)(uintptr_t) s->RecvStartPoint, (uint8_t *)(uintptr_t) s->RecvReadPoint, s->RecvRemLen);
+        s->RecvReadPoint = s->RecvStartPoint;
+        s->RecvCurPoint = s->RecvStartPoint + s->RecvRemLen;
+        room = s->RecvBufLen - s->RecvRemLen;
+    }
+    if (room == 0) return;
+
+    n = recv(HostSocks[id].fd, (uint8_t *)(uintptr_t) s->RecvCurPoint, room, MSG_DONTWAIT);
+    if (n > 0) {
+        s->RecvCurPoint += n;
+        s->RecvRemLen += n;
+        HostStats.RxBytes += n;
+        HostStats.RxSegments++;
+        Host_Raise(id, SINT_STAT_RECV);
+    }
+    else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        s->SockStatus = SOCK_STAT_CLOSED;
+        HostSocks[id].release = 1;
+        Host_Raise(id, SINT_STAT_DISCONNECT);
+    }
+}
+
+/*********************************************************************
+ * @fn      ETH_LibInit
+ *
+ * @brief   Ethernet library initialization program
+ *
+ * @return  command status
+ */
+uint8_t ETH_LibInit(uint8_t *ip, uint8_t *gwip, uint8_t *mask, uint8_t *macaddr)
+{
+    const char *env;
+    uint8_t i;
+
+    (void) gwip; (void) mask; (void) macaddr;
+
+    // WCHNET hands buffer addresses around as uint32_t
+    if ((uintptr_t)(uint32_t)(uintptr_t) SocketInf != (uintptr_t) SocketInf) {
+        printf("Host build must be linked with -no-pie\r\n");
+        return WCHNET_ERR_UNKNOW;
+    }
+
+    env = getenv("WCHNET_PORT_OFFSET");
+    PortOffset = env ? (uint16_t) atoi(env) : 0;
+
+    for (i = 0; i < WCHNET_MAX_SOCKET_NUM; i++) {
+        HostSocks[i].fd = -1;
+        memset(&SocketInf[i], 0, sizeof(SOCK_INF));
+    }
+    GlobIntStatus = GINT_STAT_PHY_CHANGE;                  // Report link up on the first query
+
+    printf("Host WCHNET: %d.%d.%d.%d, port offset %d\r\n", ip[0], ip[1], ip[2], ip[3], PortOffset);
+    return WCHNET_ERR_SUCCESS;
+}
+
+uint8_t WCHNET_GetVer(void)
+{
+    return WCHNET_LIB_VER;
+}
+
+void WCHNET_GetMacAddr(uint8_t *macaddr)
+{
+    memcpy(macaddr, HostMacAddr, 6);
+}
+
+uint8_t WCHNET_GetPHYStatus(void)
+{
+    return PHY_Linked_Status;
+}
+
+void WCHNET_TimeIsr(uint16_t timperiod)
+{
+    LocalTime += timperiod;
+}
+
+/*********************************************************************
+ * @fn      WCHNET_MainTask
+ *
+ * @brief   Wait up to HOST_POLL_TIMEOUT_MS for socket activity and turn
+ *          it into WCHNET socket interrupts.
+ *
+ * @return  none
+ */
+void WCHNET_MainTask(void)
+{
+    struct pollfd pfd[WCHNET_MAX_SOCKET_NUM];
+    uint8_t ids[WCHNET_MAX_SOCKET_NUM];
+    uint8_t conn_room;
+    int i, n = 0;
+
+    // Ids whose disconnect has been read by the application are released now
+    for (i = 0; i < WCHNET_MAX_SOCKET_NUM; i++)
+        if (HostSocks[i].release && SocketInf[i].IntStatus == 0 && SocketInf[i].RecvRemLen == 0)
+            Host_FreeId(i);
+
+    if (GlobIntStatus) return;                              // Application has work pending
+
+    conn_room = Host_ConnCount() < WCHNET_NUM_TCP;
+    for (i = 0; i < WCHNET_MAX_SOCKET_NUM; i++) {
+        if (HostSocks[i].fd < 0 || HostSocks[i].release) continue;
+        if (HostSocks[i].listening && !conn_room) continue;  // Leave it in the backlog
+        if (!HostSocks[i].listening && SocketInf[i].RecvRemLen >= SocketInf[i].RecvBufLen) continue;
+        pfd[n].fd = HostSocks[i].fd;
+        pfd[n].events = POLLIN;
+        pfd[n].revents = 0;
+        ids[n++] = i;
+    }
+
+    if (poll(pfd, n, HOST_POLL_TIMEOUT_MS) <= 0) return;
+
+    for (i = 0; i < n; i++) {
+        if (!(pfd[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+        if (HostSocks[ids[i]].listening)
+            Host_Accept(ids[i]);
+        else
+            Host_Receive(ids[i]);
+    }
+}
+
+uint8_t WCHNET_QueryGlobalInt(void)
+{
+    return GlobIntStatus;
+}
+
+uint8_t WCHNET_GetGlobalInt(void)
+{
+    uint8_t intstat = GlobIntStatus;
+
+    GlobIntStatus = 0;
+    return intstat;
+}
+
+uint8_t WCHNET_GetSocketInt(uint8_t socketid)
+{
+    uint8_t intstat;
+
+    if (socketid >= WCHNET_MAX_SOCKET_NUM) return 0;
+    intstat = SocketInf[socketid].IntStatus;
+    SocketInf[socketid].IntStatus = 0;
+    return intstat;
+}
+
+/*********************************************************************
+ * @fn      WCHNET_SocketCreat
+ *
+ * @brief   Create a TCP socket bound to socinf->SourPort (+ port offset).
+ *
+ * @return  @ERR_T
+ */
+uint8_t WCHNET_SocketCreat(uint8_t *socketid, SOCK_INF *socinf)
+{
+    struct sockaddr_in addr;
+    uint8_t id;
+    int fd, one = 1;
+
+    if (socinf->ProtoType != PROTO_TYPE_TCP) return WCHNET_ERR_UNSUPPORT_PROTO;
+
+    id = Host_AllocId();
+    if (id >= WCHNET_MAX_SOCKET_NUM) return WCHNET_ERR_SOCKET_MEM;
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return WCHNET_ERR_MEM;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(socinf->SourPort + PortOffset);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+        close(fd);
+        return WCHNET_ERR_USE;
+    }
+
+    HostSocks[id].fd = fd;
+    HostSocks[id].listening = 0;
+    HostSocks[id].release = 0;
+    SocketInf[id] = *socinf;
+    SocketInf[id].SockIndex = id;
+    SocketInf[id].SockStatus = SOCK_STAT_OPEN;
+    *socketid = id;
+    return WCHNET_ERR_SUCCESS;
+}
+
+uint8_t WCHNET_SocketListen(uint8_t socketid)
+{
+    if (socketid >= WCHNET_MAX_SOCKET_NUM || HostSocks[socketid].fd < 0) return WCHNET_ERR_SOCKET_MEM;
+    if (listen(HostSocks[socketid].fd, 16) < 0) return WCHNET_ERR_USE;
+    HostSocks[socketid].listening = 1;
+    SocketInf[socketid].SockStatus = SOCK_STAT_OPEN | (TCP_LISTEN << 8);
+    return WCHNET_ERR_SUCCESS;
+}
+
+uint8_t WCHNET_SocketConnect(uint8_t socketid)
+{
+    (void) socketid;
+    return WCHNET_ERR_UNSUPPORT_PROTO;
+}
+
+/*********************************************************************
+ * @fn      WCHNET_SocketClose
+ *
+ * @brief   Close socket, TCP_CLOSE_RST/TCP_CLOSE_ABANDON reset the peer.
+ *
+ * @return  @ERR_T
+ */
+uint8_t WCHNET_SocketClose(uint8_t socketid, uint8_t mode)
+{
+    struct linger lg = {1, 0};
+
+    if (socketid >= WCHNET_MAX_SOCKET_NUM || HostSocks[socketid].fd < 0) return WCHNET_ERR_SOCKET_MEM;
+    if (mode != TCP_CLOSE_NORMAL)
+        setsockopt(HostSocks[socketid].fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+    if (!HostSocks[socketid].listening) HostStats.Closes++;
+    Host_FreeId(socketid);
+    return WCHNET_ERR_SUCCESS;
+}
+
+void WCHNET_ModifyRecvBuf(uint8_t socketid, uint32_t bufaddr, uint32_t bufsize)
+{
+    SOCK_INF *s;
+
+    if (socketid >= WCHNET_MAX_SOCKET_NUM) return;
+    s = &SocketInf[socketid];
+    s->RecvStartPoint = s->RecvCurPoint = s->RecvReadPoint = bufaddr;
+    s->RecvBufLen = bufsize;
+    s->RecvRemLen = 0;
+}
+
+uint32_t WCHNET_SocketRecvLen(uint8_t socketid, uint32_t *bufaddr)
+{
+    if (socketid >= WCHNET_MAX_SOCKET_NUM) return 0;
+    if (bufaddr) *bufaddr = SocketInf[socketid].RecvReadPoint;
+    return SocketInf[socketid].RecvRemLen;
+}
+
+/*********************************************************************
+ * @fn      WCHNET_SocketRecv
+ *
+ * @brief   Copy out up to *len received bytes (buf != NULL) or only
+ *          consume them (buf == NULL).
+ *
+ * @return  @ERR_T
+ */
+uint8_t WCHNET_SocketRecv(uint8_t socketid, uint8_t *buf, uint32_t *len)
+{
+    SOCK_INF *s;
+    uint32_t n;
+
+    if (socketid >= WCHNET_MAX_SOCKET_NUM) return WCHNET_ERR_SOCKET_MEM;
+    s = &SocketInf[socketid];
+    n = (*len < s->RecvRemLen) ? *len : s->RecvRemLen;
+    if (buf) memcpy(buf, (uint8_t *)(uintptr_t) s->RecvReadPoint, n);
+    s->RecvReadPoint += n;
+    s->RecvRemLen -= n;
+    if (s->RecvRemLen == 0)
+        s->RecvReadPoint = s->RecvCurPoint = s->RecvStartPoint;
+    *len = n;
+    return WCHNET_ERR_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      WCHNET_SocketSend
+ *
+ * @brief   Send *len bytes, *len is updated with the number sent.
+ *
+ * @return  @ERR_T
+ */
+uint8_t WCHNET_SocketSend(uint8_t socketid, uint8_t *buf, uint32_t *len)
+{
+    ssize_t n;
+
+    if (socketid >= WCHNET_MAX_SOCKET_NUM || HostSocks[socketid].fd < 0) {
+        *len = 0;
+        return WCHNET_ERR_SOCKET_MEM;
+    }
+    n = send(HostSocks[socketid].fd, buf, *len, MSG_NOSIGNAL);
+    if (n < 0) {
+        *len = 0;
+        return WCHNET_ERR_CONN;
+    }
+    *len = n;
+    HostStats.TxBytes += n;
+    HostStats.TxSegments++;
+    return WCHNET_ERR_SUCCESS;
+}
@@ -0,0 +1,119 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusDevId.c
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus Read Device Identification (FC43 / MEI 14). The objects are
+ *               encoded once at boot as they go on the wire, a request is answered
+ *               by copying the run of objects it asks for.
+*********************************************************************************/
+/* Include header files ----------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ModbusDevId.h"
+
+/* Private macro definition ----------------------------------------------------------------*/
+#define DEVID_CONFORMITY   0x83 // Extended identification, stream and individual access
+#define DEVID_BUF_LEN      200  // All objects encoded, must fit one response (max. 246)
+
+// Read Device ID code of the category an object belongs to
+#define DEVID_CODE(id)     (((id) <= 0x02) ? 1 : (((id) < 0x80) ? 2 : 3))
+
+/* Private type definition ----------------------------------------------------------------*/
+typedef struct
+{
+    uint8_t Id;                 // Object id
+    const char *Value;          // Object value, ASCII
+} MB_DevId_Object;
+
+/* Private variable ------------------------------------------------------------------*/
+static char ChipIdStr[9];       // "30700528"
+static char MacStr[18];         // "xx:xx:xx:xx:xx:xx"
+
+static const MB_DevId_Object DevIdTable[] = {  // Sorted by object id
+    { 0x00, MB_DEVID_VENDOR_NAME },
+    { 0x01, MB_DEVID_PRODUCT_CODE },
+    { 0x02, MB_DEVID_REVISION },
+    { 0x04, MB_DEVID_PRODUCT_NAME },
+    { 0x05, MB_DEVID_MODEL_NAME },
+    { 0x80, ChipIdStr },
+    { 0x81, MacStr },
+};
+
+#define DEVID_NUM  (sizeof(DevIdTable) / sizeof(DevIdTable[0]))
+
+static uint8_t DevIdBuf[DEVID_BUF_LEN];       // Objects as on the wire: id, length, value
+static uint8_t DevIdOffset[DEVID_NUM + 1];    // Start of each object in DevIdBuf
+
+/*********************************************************************
+ * Function: Build the response objects
+ * Input parameters: chipid - DBGMCU_GetCHIPID(), mac - WCHNET_GetMacAddr() address
+ * Return value: None
+ * Description: Called once at boot, objects that do not fit DEVID_BUF_LEN are left out.
+ */
+void MB_DevId_Init(uint32_t chipid, const uint8_t *mac)
+{
+    uint16_t pos = 0, n;
+    uint8_t i;
+
+    sprintf(ChipIdStr, "%08lx", (unsigned long) chipid);
+    sprintf(MacStr, "%02x:%02x:%02x:%02x:%02x:%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+
+    for (i = 0; i < DEVID_NUM; i++)
+    {
+        DevIdOffset[i] = pos;
+        n = strlen(DevIdTable[i].Value);
+        if (pos + 2 + n <= DEVID_BUF_LEN)
+        {
+            DevIdBuf[pos++] = DevIdTable[i].Id;
+            DevIdBuf[pos++] = n;
+            memcpy(&DevIdBuf[pos], DevIdTable[i].Value, n);
+            pos += n;
+        }
+    }
+    DevIdOffset[DEVID_NUM] = pos;
+}
+
+/*********************************************************************
+ * Function: Read Device Identification response
+ * Input parameters: code - Read Device ID code 1..4, object - Object Id
+ *                   dst - response PDU after the MEI type, len - its length
+ * Return value: 0, or the Modbus exception code to answer with
+ * Description: Codes 1..3 stream all objects of the category from the object
+ *              asked for, from the first one when it is not in the category.
+ *              Code 4 returns the one object, exception 02 if there is none.
+ */
+uint8_t MB_DevId_Read(uint8_t code, uint8_t object, uint8_t *dst, uint16_t *len)
+{
+    uint8_t first, last, i;
+
+    if ((code == 0) || (code > 4))
+        return 0x03;                                // Illegal data value
+
+    for (i = 0; (i < DEVID_NUM) && (DevIdTable[i].Id != object); i++);
+
+    if (code == 4)
+    {
+        if (i == DEVID_NUM)
+            return 0x02;                            // Illegal data address
+        first = i;
+        last = i + 1;
+    }
+    else
+    {
+        first = ((i < DEVID_NUM) && (DEVID_CODE(object) <= code)) ? i : 0;
+        for (last = first; (last < DEVID_NUM) && (DEVID_CODE(DevIdTable[last].Id) <= code); last++);
+    }
+
+    dst[0] = code;                                  // Read Device ID code
+    dst[1] = DEVID_CONFORMITY;                      // Conformity level
+    dst[2] = 0x00;                                  // More follows, all objects fit
+    dst[3] = 0x00;                                  // Next object id
+    dst[4] = last - first;                          // Number of objects
+    *len = DevIdOffset[last] - DevIdOffset[first];
+    memcpy(&dst[5], &DevIdBuf[DevIdOffset[first]], *len);
+    *len += 5;
+    return 0;
+}
+
+/********************************* END OF FILE ************************************/
@@ -0,0 +1,29 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusDevId.h
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus Read Device Identification (FC43 / MEI 14) objects.
+*********************************************************************************/
+
+#ifndef __MODBUSDEVID_H__
+#define __MODBUSDEVID_H__
+
+/* Include header file ----------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Macro definition --------------------------------------------------------------------*/
+#define MB_DEVID_VENDOR_NAME   "Nedelcu Bogdan Sebastian"               // Object 0x00
+#define MB_DEVID_PRODUCT_CODE  "CH32V307-JMWA"                          // Object 0x01
+#define MB_DEVID_REVISION      "V1.0.0"                                 // Object 0x02
+#define MB_DEVID_PRODUCT_NAME  "JSON MODBUS WEBSOCKET AJAX Server"      // Object 0x04
+#define MB_DEVID_MODEL_NAME    "CH32V307"                               // Object 0x05
+                                                                        // Object 0x80 ChipID, 0x81 MAC address
+
+/* Function declaration ------------------------------------------------------------------*/
+void MB_DevId_Init(uint32_t chipid, const uint8_t *mac); // Build the response objects, once at boot
+uint8_t MB_DevId_Read(uint8_t code, uint8_t object, uint8_t *dst, uint16_t *len); // 0 or exception code
+
+#endif
+
+/********************************* END OF FILE ************************************/
@@ -0,0 +1,309 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusGateway.c
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus TCP gateway. A request for a downstream unit id is one
+ *               transaction on the route's transport. Reads (FC01..FC04) are keyed
+ *               by unit, function code, address and count: clients asking for the
+ *               same points while a transaction is in flight wait for it, and its
+ *               response answers them for MB_GW_CACHE_MS afterwards. Any other
+ *               request for a unit drops the cached reads of that unit.
+*********************************************************************************/
+/* Include header files ----------------------------------------------------------------*/
+#include <stddef.h>
+#include <string.h>
+#include "eth_driver.h"
+#include "ModbusGateway.h"
+
+/* Private macro definition ----------------------------------------------------------------*/
+#define GW_FREE        0   // Entry states
+#define GW_PENDING     1   // Transaction in flight
+#define GW_VALID       2   // Cached read response
+
+#define GW_KEY_LEN     5   // Function code, address, count of a read request
+
+/* Private type definition ----------------------------------------------------------------*/
+typedef struct
+{
+    uint8_t State;                  // GW_FREE, GW_PENDING, GW_VALID
+    uint8_t Keep;                   // Cache the response once it arrives
+    uint8_t Seq;                    // Tag generation, late responses are ignored
+    uint8_t Unit;                   // Unit id
+    uint8_t Key[GW_KEY_LEN];        // Request PDU of a read, Key[0] is the function code
+    uint16_t Len;                   // Response PDU length
+    uint32_t Time;                  // LocalTime of the request, then of the response
+    uint8_t Pdu[MB_GW_PDU_MAX];     // Response PDU
+} GW_Entry;
+
+typedef struct
+{
+    uint8_t Used;                   // Waiter in use
+    uint8_t Entry;                  // Transaction waited for
+    uint8_t Socket;                 // Client connection
+    uint8_t Mbap[4];                // Transaction and protocol identifier to answer with
+} GW_Waiter;
+
+/* Private variable ------------------------------------------------------------------*/
+static GW_Entry GW_Entries[MB_GW_ENTRY_NUM];
+static GW_Waiter GW_Waiters[MB_GW_WAITER_NUM];
+MB_GW_Stat MB_GW_Stats;
+
+/*********************************************************************
+ * Function: Route of a unit id
+ * Input parameter: unit - unit id
+ * Return value: Route, NULL if the unit id has none
+ */
+static const MB_GW_Route *GW_Find(uint8_t unit)
+{
+    uint8_t i;
+
+    for (i = 0; i < MB_GW_Routes.Num; i++)
+        if ((unit >= MB_GW_Routes.Routes[i].First) && (unit <= MB_GW_Routes.Routes[i].Last))
+            return &MB_GW_Routes.Routes[i];
+    return NULL;
+}
+
+/*********************************************************************
+ * Function: Queue a response in a session
+ * Input parameters: s - Modbus session, mbap - transaction and protocol identifier
+ *                   unit - unit id, pdu/len - response PDU
+ * Return value: None
+ * Description: The caller makes sure 7 + len bytes are free in s->Tx.
+ */
+static void GW_Reply(MB_Session *s, const uint8_t *mbap, uint8_t unit, const uint8_t *pdu, uint16_t len)
+{
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+
+    memcpy(Tx_Adu, mbap, 4);        // Transaction and protocol identifier
+    Tx_Adu[4] = (len + 1) >> 8;     // Number of bytes to follow
+    Tx_Adu[5] = len + 1;
+    Tx_Adu[6] = unit;               // Station number
+    memcpy(&Tx_Adu[7], pdu, len);
+
+    s->TxLen += 7 + len; // Queue for sending
+}
+
+/*********************************************************************
+ * Function: Queue an exception response in a session
+ * Input parameters: s - Modbus session, mbap, unit - as GW_Reply
+ *                   fc - function code, ex - exception code
+ * Return value: None
+ */
+static void GW_Exception(MB_Session *s, const uint8_t *mbap, uint8_t unit, uint8_t fc, uint8_t ex)
+{
+    uint8_t pdu[2] = { fc | 0x80, ex };
+
+    GW_Reply(s, mbap, unit, pdu, 2);
+}
+
+/*********************************************************************
+ * Function: Is a unit id local
+ * Input parameter: unit - unit id
+ * Return value: 1 - served by the local register map, 0 - by MB_GW_Request
+ */
+uint8_t MB_GW_Local(uint8_t unit)
+{
+    if ((unit == MB_GW_LOCAL_UNIT) || (unit == TCP_ALLSLAVEADDR))
+        return 1;
+    return (MB_GW_UNROUTED_LOCAL && (GW_Find(unit) == NULL));
+}
+
+/*********************************************************************
+ * Function: Serve a request for a downstream unit id
+ * Input parameter: s - Modbus session, s->RxAdu is the request
+ * Return value: None
+ * Description: A fresh cached response is queued in s->Tx straight away. Otherwise
+ *              the request waits for a transaction, a new one or the one in flight
+ *              for the same read, and is answered by MB_GW_Done. Exception 0A if the
+ *              unit id has no route, 06 if no entry or waiter is free.
+ */
+void MB_GW_Request(MB_Session *s)
+{
+    const uint8_t *Rx_Adu = s->RxAdu;
+    const MB_GW_Route *r = GW_Find(Rx_Adu[6]);
+    uint16_t len = (Rx_Adu[5] | Rx_Adu[4] << 8) - 1; // PDU
+    uint8_t read = (Rx_Adu[7] >= 1) && (Rx_Adu[7] <= 4) && (len == GW_KEY_LEN);
+    GW_Entry *e = NULL, *old = NULL;
+    GW_Waiter *w = NULL;
+    uint8_t i, ex;
+
+    if (r == NULL)
+    {
+        GW_Exception(s, Rx_Adu, Rx_Adu[6], Rx_Adu[7], 0x0A); // Gateway path unavailable
+        return;
+    }
+
+    for (i = 0; i < MB_GW_ENTRY_NUM; i++)
+    {
+        if ((GW_Entries[i].State == GW_FREE) || (GW_Entries[i].Unit != Rx_Adu[6]))
+            continue;
+        if (!read)                                    // The unit is written, forget its reads
+        {
+            if (GW_Entries[i].State == GW_VALID)
+                GW_Entries[i].State = GW_FREE;
+            GW_Entries[i].Keep = 0;
+        }
+        else if (memcmp(GW_Entries[i].Key, &Rx_Adu[7], GW_KEY_LEN) == 0)
+        {
+            if ((GW_Entries[i].State == GW_PENDING) && GW_Entries[i].Keep)
+                e = &GW_Entries[i];
+            else if ((GW_Entries[i].State == GW_VALID) && (LocalTime - GW_Entries[i].Time <= MB_GW_CACHE_MS))
+            {
+                MB_GW_Stats.CacheHits++;
+                GW_Reply(s, Rx_Adu, Rx_Adu[6], GW_Entries[i].Pdu, GW_Entries[i].Len);
+                return;
+            }
+        }
+    }
+
+    for (i = 0; (w == NULL) && (i < MB_GW_WAITER_NUM); i++)
+        if (!GW_Waiters[i].Used)
+            w = &GW_Waiters[i];
+
+    if ((w != NULL) && (e != NULL))                   // Same read already in flight
+    {
+        MB_GW_Stats.Joined++;
+    }
+    else if (w != NULL)                               // New transaction: a free entry, else the oldest cached one
+    {
+        for (i = 0; (e == NULL) && (i < MB_GW_ENTRY_NUM); i++)
+        {
+            if (GW_Entries[i].State == GW_FREE)
+                e = &GW_Entries[i];
+            else if ((GW_Entries[i].State == GW_VALID) &&
+                     ((old == NULL) || (LocalTime - GW_Entries[i].Time > LocalTime - old->Time)))
+                old = &GW_Entries[i];
+        }
+        if (e == NULL)
+            e = old;
+    }
+    if ((w == NULL) || (e == NULL))
+    {
+        GW_Exception(s, Rx_Adu, Rx_Adu[6], Rx_Adu[7], 0x06); // Server device busy
+        return;
+    }
+
+    if (e->State != GW_PENDING)
+    {
+        e->State = GW_PENDING;
+        e->Keep = read;
+        e->Seq++;
+        e->Unit = Rx_Adu[6];
+        e->Time = LocalTime;
+        memcpy(e->Key, &Rx_Adu[7], read ? GW_KEY_LEN : 1);
+
+        ex = r->Submit(s->Socket, e->Unit, &Rx_Adu[7], len, (e->Seq << 8) | (e - GW_Entries));
+        if (ex)
+        {
+            e->State = GW_FREE;
+            GW_Exception(s, Rx_Adu, Rx_Adu[6], Rx_Adu[7], ex);
+            return;
+        }
+        MB_GW_Stats.Forwarded++;
+    }
+
+    w->Used = 1;
+    w->Entry = e - GW_Entries;
+    w->Socket = s->Socket;
+    memcpy(w->Mbap, Rx_Adu, 4);
+}
+
+/*********************************************************************
+ * Function: Downstream transaction done
+ * Input parameters: tag - tag given to the transport, pdu/len - response PDU,
+ *                   pdu NULL if the device did not answer
+ * Return value: None
+ * Description: Every client waiting for the transaction gets the response, or
+ *              exception 0B, and all of them are sent before returning. A read
+ *              response is kept in the cache.
+ */
+void MB_GW_Done(uint16_t tag, const uint8_t *pdu, uint16_t len)
+{
+    uint8_t idx = tag & 0xFF;
+    GW_Entry *e;
+    MB_Session *sent[TCP_SESSION_NUM], *s;
+    uint8_t i, j, n = 0;
+
+    if (idx >= MB_GW_ENTRY_NUM)
+        return;
+    e = &GW_Entries[idx];
+    if ((e->State != GW_PENDING) || (e->Seq != (tag >> 8)))
+        return;                                       // Timed out before, or not ours
+    if (len > MB_GW_PDU_MAX)
+        pdu = NULL;
+
+    for (i = 0; i < MB_GW_WAITER_NUM; i++)
+    {
+        if (!GW_Waiters[i].Used || (GW_Waiters[i].Entry != idx))
+            continue;
+        GW_Waiters[i].Used = 0;
+
+        s = MB_Session_Get(GW_Waiters[i].Socket);
+        if (s == NULL)
+            continue;
+        if (!MB_TCP_Room(s, 7 + MB_GW_PDU_MAX)) // Connection closed
+            continue;
+
+        if (pdu != NULL)
+            GW_Reply(s, GW_Waiters[i].Mbap, e->Unit, pdu, len);
+        else
+            GW_Exception(s, GW_Waiters[i].Mbap, e->Unit, e->Key[0], 0x0B); // Target device failed to respond
+        s->TxNum++;
+
+        for (j = 0; (j < n) && (sent[j] != s); j++);
+        if (j == n)
+            sent[n++] = s;
+    }
+
+    if ((pdu != NULL) && e->Keep && !(pdu[0] & 0x80)) // Exceptions are not cached
+    {
+        e->State = GW_VALID;
+        e->Time = LocalTime;
+        e->Len = len;
+        memcpy(e->Pdu, pdu, len);
+    }
+    else
+        e->State = GW_FREE;
+
+    for (j = 0; j < n; j++)
+        MB_TCP_Flush(sent[j]);
+}
+
+/*********************************************************************
+ * Function: Forget the requests of a connection
+ * Input parameter: socketid - socket id
+ * Return value: None
+ * Description: Their transactions go on, the responses may still be cached.
+ */
+void MB_GW_Drop(uint8_t socketid)
+{
+    uint8_t i;
+
+    for (i = 0; i < MB_GW_WAITER_NUM; i++)
+        if (GW_Waiters[i].Socket == socketid)
+            GW_Waiters[i].Used = 0;
+}
+
+/*********************************************************************
+ * Function: Gateway housekeeping
+ * Input parameter: None
+ * Return value: None
+ * Description: A transaction older than MB_GW_TIMEOUT_MS is finished with exception
+ *              0B, a later response from the transport is ignored.
+ */
+void MB_GW_Poll(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < MB_GW_ENTRY_NUM; i++)
+    {
+        if ((GW_Entries[i].State == GW_PENDING) && (LocalTime - GW_Entries[i].Time > MB_GW_TIMEOUT_MS))
+        {
+            MB_GW_Stats.Timeouts++;
+            MB_GW_Done((GW_Entries[i].Seq << 8) | i, NULL, 0);
+        }
+    }
+}
+
+/********************************* END OF FILE ************************************/
@@ -0,0 +1,74 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusGateway.h
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus TCP gateway, requests for unit ids of downstream devices are
+ *               forwarded over a transport, read responses are cached.
+*********************************************************************************/
+
+#ifndef __MODBUSGATEWAY_H__
+#define __MODBUSGATEWAY_H__
+
+/* Include header file ----------------------------------------------------------------*/
+#include <stdint.h>
+#include "ModbusTCP.h"
+
+/* Macro definition --------------------------------------------------------------------*/
+#define MB_GW_LOCAL_UNIT      1     // Unit id of the local register map, 255 is local too
+#define MB_GW_UNROUTED_LOCAL  1     // 1: unit ids without a route are served locally,
+                                    // 0: they get exception 0A (gateway path unavailable)
+#define MB_GW_ENTRY_NUM       8     // Downstream transactions in flight + cached responses
+#define MB_GW_WAITER_NUM      16    // Client requests waiting for a downstream response
+#define MB_GW_PDU_MAX         253   // Largest Modbus PDU
+#define MB_GW_CACHE_MS        200   // Max. age of a cached read response
+#define MB_GW_TIMEOUT_MS      1000  // Downstream transaction gets exception 0B after this
+
+#if (MB_GW_ENTRY_NUM > 255) || (MB_GW_WAITER_NUM > 255)
+    #error "MB_GW_ENTRY_NUM/MB_GW_WAITER_NUM Error,Please Configure them below 256"
+#endif
+
+/* Type definition ------------------------------------------------------------------*/
+/*
+ * Start a downstream transaction: pdu is function code + data, len bytes, only valid
+ * during the call, client is the socket id of the client that asked first. Return 0 if
+ * the transport took it, it then calls MB_GW_Done with the same tag once, from the main
+ * loop. Otherwise return the exception code to answer with.
+ */
+typedef uint8_t (*MB_GW_SubmitFn)(uint8_t client, uint8_t unit, const uint8_t *pdu, uint16_t len, uint16_t tag);
+
+typedef struct
+{
+    uint8_t First;              // First unit id of the route
+    uint8_t Last;               // Last unit id of the route
+    MB_GW_SubmitFn Submit;      // Transport to the devices
+} MB_GW_Route;
+
+typedef struct
+{
+    const MB_GW_Route *Routes;  // First match wins
+    uint8_t Num;
+} MB_GW_Table;
+
+typedef struct
+{
+    uint32_t Forwarded;         // Downstream transactions started
+    uint32_t CacheHits;         // Requests answered from the cache
+    uint32_t Joined;            // Requests that waited for a transaction already in flight
+    uint32_t Timeouts;          // Transactions without a response, exception 0B
+} MB_GW_Stat;
+
+/* Extended variables ------------------------------------------------------------------*/
+extern const MB_GW_Table MB_GW_Routes; // Provided by the application (User/ModbusRegs.c)
+extern MB_GW_Stat MB_GW_Stats;
+
+/* Function declaration ------------------------------------------------------------------*/
+uint8_t MB_GW_Local(uint8_t unit);      // 1 if the unit id is served by the local register map
+void MB_GW_Request(MB_Session *s);      // Forward s->RxAdu, or answer it from the cache
+void MB_GW_Done(uint16_t tag, const uint8_t *pdu, uint16_t len); // Downstream response, pdu NULL: none
+void MB_GW_Drop(uint8_t socketid);      // Connection closed, forget its requests
+void MB_GW_Poll(void);                  // Transaction timeouts, call from the main loop
+
+#endif
+
+/********************************* END OF FILE ************************************/
@@ -0,0 +1,108 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusJournal.c
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus register change journal. Every change of a journaled register
+ *               gets the next sequence number and goes into a ring of the last
+ *               MB_JOURNAL_NUM changes, so a client that remembers where it stopped
+ *               reads only what changed since instead of polling the whole block.
+ *               Logged and read from the main loop only.
+*********************************************************************************/
+/* Include header files ----------------------------------------------------------------*/
+#include <stddef.h>
+#include "eth_driver.h"
+#include "ModbusMap.h"
+#include "ModbusJournal.h"
+
+/* Private type definition ----------------------------------------------------------------*/
+typedef struct
+{
+    uint8_t Space;                  // MB_SPACE_HOLDING or MB_SPACE_INPUT
+    uint16_t Addr;                  // Register address
+    uint16_t Value;                 // New value
+    uint32_t Time;                  // LocalTime of the change
+} MB_JournalEntry;
+
+/* Private variable ------------------------------------------------------------------*/
+static MB_JournalEntry Journal[MB_JOURNAL_NUM]; // Change n is Journal[n % MB_JOURNAL_NUM]
+static uint32_t JournalSeq;                     // Sequence number of the next change
+static uint16_t JournalNum;                     // Changes held, MB_JOURNAL_NUM once it is full
+
+/*********************************************************************
+ * Function: Log a register change
+ * Input parameters: space - MB_SPACE_xxx, addr - register address, value - new value
+ * Return value: None
+ * Description: The oldest change is overwritten once the journal is full.
+ */
+void MB_Journal_Log(uint8_t space, uint16_t addr, uint16_t value)
+{
+    MB_JournalEntry *e = &Journal[JournalSeq & (MB_JOURNAL_NUM - 1)];
+
+    e->Space = space;
+    e->Addr = addr;
+    e->Value = value;
+    e->Time = LocalTime;
+    JournalSeq++;
+    if (JournalNum < MB_JOURNAL_NUM)
+        JournalNum++;
+}
+
+/*********************************************************************
+ * Function: Log the registers of a block that changed
+ * Input parameters: space - MB_SPACE_xxx, addr - address of the first register
+ *                   old/cur - values before and after, count - number of registers
+ * Return value: None
+ */
+void MB_Journal_Diff(uint8_t space, uint16_t addr, const uint16_t *old, const uint16_t *cur, uint16_t count)
+{
+    uint16_t i;
+
+    for (i = 0; i < count; i++)
+        if (old[i] != cur[i])
+            MB_Journal_Log(space, addr + i, cur[i]);
+}
+
+/*********************************************************************
+ * Function: Read the changes since a sequence number
+ * Input parameters: seq - in: first change wanted, out: sequence number to read from next
+ *                   num - in: max. number of changes, out: changes written to dst
+ *                   dst - MB_JOURNAL_REC_LEN bytes per change: function code that reads
+ *                         the register (03 or 04), address (high byte first), value (low
+ *                         byte first, as in a FC03 response), LocalTime (high byte first)
+ * Return value: MB_JOURNAL_DONE, MB_JOURNAL_MORE, or MB_JOURNAL_LOST with no changes
+ *               written if the journal no longer holds change *seq (or never did: a
+ *               sequence number from before a restart)
+ */
+uint8_t MB_Journal_Read(uint32_t *seq, uint8_t *num, uint8_t *dst)
+{
+    const MB_JournalEntry *e;
+    uint32_t n = *seq;
+    uint8_t i;
+
+    if (JournalSeq - n > JournalNum)
+    {
+        *seq = JournalSeq;
+        *num = 0;
+        return MB_JOURNAL_LOST;
+    }
+
+    for (i = 0; (i < *num) && (n != JournalSeq); i++, n++)
+    {
+        e = &Journal[n & (MB_JOURNAL_NUM - 1)];
+        *dst++ = (e->Space == MB_SPACE_INPUT) ? 0x04 : 0x03;
+        *dst++ = e->Addr >> 8;
+        *dst++ = e->Addr;
+        *dst++ = e->Value;                          // Low byte
+        *dst++ = e->Value >> 8;                     // High byte
+        *dst++ = e->Time >> 24;
+        *dst++ = e->Time >> 16;
+        *dst++ = e->Time >> 8;
+        *dst++ = e->Time;
+    }
+    *seq = n;
+    *num = i;
+    return (n == JournalSeq) ? MB_JOURNAL_DONE : MB_JOURNAL_MORE;
+}
+
+/********************************* END OF FILE ************************************/
@@ -0,0 +1,36 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusJournal.h
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus register change journal, the last register changes with
+ *               their time, read by clients with FC65 (Read Changes).
+*********************************************************************************/
+
+#ifndef __MODBUSJOURNAL_H__
+#define __MODBUSJOURNAL_H__
+
+/* Include header file ----------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Macro definition --------------------------------------------------------------------*/
+#define MB_JOURNAL_NUM        128   // Changes kept, power of 2
+#define MB_JOURNAL_REC_LEN    9     // Bytes per change in a FC65 response
+
+#define MB_JOURNAL_DONE       0     // Read status: all changes up to now returned
+#define MB_JOURNAL_MORE       1     // More changes follow, read again from the next sequence number
+#define MB_JOURNAL_LOST       2     // Changes since the sequence number are no longer kept,
+                                    // read the registers in full, then go on from the next one
+
+#if (MB_JOURNAL_NUM & (MB_JOURNAL_NUM - 1))
+    #error "MB_JOURNAL_NUM Error,Please Configure it as a power of 2"
+#endif
+
+/* Function declaration ------------------------------------------------------------------*/
+void MB_Journal_Log(uint8_t space, uint16_t addr, uint16_t value); // Register of MB_SPACE_xxx changed
+void MB_Journal_Diff(uint8_t space, uint16_t addr, const uint16_t *old, const uint16_t *cur, uint16_t count); // Log the differences
+uint8_t MB_Journal_Read(uint32_t *seq, uint8_t *num, uint8_t *dst); // Changes from *seq on, MB_JOURNAL_xxx
+
+#endif
+
+/********************************* END OF FILE ************************************/
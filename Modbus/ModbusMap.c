@@ -0,0 +1,328 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusMap.c
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus register map lookup and access. A request is served by the
+ *               one region that holds its whole address range, found by binary search.
+*********************************************************************************/
+/* Include header files ----------------------------------------------------------------*/
+#include <stddef.h>
+#include <string.h>
+#include "ModbusMap.h"
+#include "ModbusJournal.h"
+
+/* Private function declaration --------------------------------------------------------------*/
+static void MB_Read_Bits(const uint32_t *src, uint16_t addr, uint16_t count, uint8_t *dst); // Bit range -> packed bytes
+static void MB_Write_Bits(uint32_t *dst, uint16_t addr, uint16_t count, const uint8_t *src); // Packed bytes -> bit range
+static void MB_Read_Ram(uint8_t space, const void *data, uint16_t addr, uint16_t count, uint8_t *dst); // RAM range -> wire format
+
+/* Private macro definition ----------------------------------------------------------------*/
+// Bit regions are read and written 32 bits at a time, bit n of a region is bit (n % 32)
+// of word n / 32, on a little endian core the same as bit (n % 8) of byte n / 8
+
+// Banks are shared with interrupt handlers and DMA completion code on the same core,
+// only the compiler has to be kept from moving loads and stores across the Seq accesses
+#define MB_BARRIER()    __asm volatile ("" ::: "memory")
+
+/*********************************************************************
+ * Function: find the region holding a whole address range
+ * Input parameters: space - MB_SPACE_xxx, addr - first address, count - number of items
+ * Return value: region, NULL if no single region holds addr .. addr + count - 1
+ * Description: Binary search on the sorted region table.
+ */
+const MB_Region *MB_Map_Find(uint8_t space, uint16_t addr, uint16_t count)
+{
+    const MB_Table *t = &MB_Map[space];
+    const MB_Region *r;
+    int16_t lo = 0, hi = (int16_t) t->Num - 1, mid;
+
+    while (lo <= hi)
+    {
+        mid = (lo + hi) / 2;
+        r = &t->Regions[mid];
+
+        if (addr < r->Start)
+            hi = mid - 1;
+        else if ((uint16_t)(addr - r->Start) >= r->Count)
+            lo = mid + 1;
+        else
+            return ((uint32_t) addr + count <= (uint32_t) r->Start + r->Count) ? r : NULL;
+    }
+    return NULL;
+}
+
+/*********************************************************************
+ * Function: copy a bit range out of a packed bit table
+ * Input parameters: src - bit table, 32 bits per word
+ *                   addr - first bit, count - number of bits
+ *                   dst - output, bit 0 of the range in bit 0 of dst[0]
+ * Return value: none
+ * Description: Works a 32-bit word at a time, each output word is the current table
+ *              word shifted down and topped up from the next one. Unused high bits of
+ *              the last output byte are zero. The caller checks addr + count against
+ *              the table size, the next word is only read when bits are needed from it.
+ */
+static void MB_Read_Bits(const uint32_t *src, uint16_t addr, uint16_t count, uint8_t *dst)
+{
+    const uint32_t *w = src + (addr >> 5);
+    uint8_t shift = addr & 31;
+    uint8_t n, i;
+    uint32_t v;
+
+    while (count)
+    {
+        n = (count < 32) ? count : 32;              // Bits in this output word
+
+        v = w[0] >> shift;
+        if (shift + n > 32)                         // Top up from the next table word
+            v |= w[1] << (32 - shift);
+        if (n < 32)
+            v &= (1UL << n) - 1;
+
+        for (i = 0; i < n; i += 8)                  // Tx buffer is byte aligned
+        {
+            *dst++ = v;
+            v >>= 8;
+        }
+        w++;
+        count -= n;
+    }
+}
+
+/*********************************************************************
+ * Function: copy packed bits into a bit range of a packed bit table
+ * Input parameters: dst - bit table, 32 bits per word
+ *                   addr - first bit, count - number of bits
+ *                   src - input, bit 0 of the range in bit 0 of src[0], any alignment
+ * Return value: none
+ * Description: Mirror of MB_Read_Bits. Up to 32 source bits are gathered into a word and
+ *              merged into one or two table words with masked stores, table bits outside
+ *              the range are left as they are. The caller checks addr + count against the
+ *              table size, the next word is only touched when the range reaches into it.
+ */
+static void MB_Write_Bits(uint32_t *dst, uint16_t addr, uint16_t count, const uint8_t *src)
+{
+    uint32_t *w = dst + (addr >> 5);
+    uint8_t shift = addr & 31;
+    uint8_t n, i;
+    uint32_t v, mask;
+
+    while (count)
+    {
+        n = (count < 32) ? count : 32;              // Bits in this source word
+
+        v = 0;
+        for (i = 0; i < n; i += 8)                  // Rx buffer is byte aligned
+            v |= (uint32_t) *src++ << i;
+        mask = (n < 32) ? ((1UL << n) - 1) : 0xFFFFFFFFUL;
+        v &= mask;
+
+        w[0] = (w[0] & ~(mask << shift)) | (v << shift);
+        if (shift + n > 32)                         // Spill into the next table word
+            w[1] = (w[1] & ~(mask >> (32 - shift))) | (v >> (32 - shift));
+        w++;
+        count -= n;
+    }
+}
+
+/*********************************************************************
+ * Function: check the application register map
+ * Input parameters: none
+ * Return value: 0 - map is usable, otherwise 1 + the space that is not
+ * Description: Regions must be sorted by Start and not overlap for the binary search,
+ *              must not wrap past address 0xFFFF, and RAM bit regions must be word aligned.
+ */
+uint8_t MB_Map_Check(void)
+{
+    const MB_Region *r;
+    uint32_t next;
+    uint8_t s, i;
+
+    for (s = 0; s < MB_SPACE_NUM; s++)
+    {
+        next = 0;
+        for (i = 0; i < MB_Map[s].Num; i++)
+        {
+            r = &MB_Map[s].Regions[i];
+            if ((r->Start < next) || (r->Count == 0) || ((uint32_t) r->Start + r->Count > 0x10000))
+                return s + 1;
+            if ((r->Data == NULL) && (r->Read == NULL))
+                return s + 1;
+            if (MB_SPACE_IS_BITS(s) && ((uintptr_t) r->Data & 3))
+                return s + 1;
+            if (MB_SPACE_IS_BITS(s) && (r->Flags & MB_REGION_JOURNAL))
+                return s + 1;
+            if ((r->Flags & MB_REGION_BANK) && (r->Data != NULL))
+            {
+                const MB_Bank *b = (const MB_Bank *) r->Data;
+
+                if (b->Size < (MB_SPACE_IS_BITS(s) ? (r->Count + 31) / 32 * 4 : r->Count * 2))
+                    return s + 1;
+                if (MB_SPACE_IS_BITS(s) && (((uintptr_t) b->Buf[0] | (uintptr_t) b->Buf[1]) & 3))
+                    return s + 1;
+            }
+            next = (uint32_t) r->Start + r->Count;
+        }
+    }
+    return 0;
+}
+
+/*********************************************************************
+ * Function: copy a range of a RAM region out in wire format
+ * Input parameters: space - MB_SPACE_xxx, data - RAM backing, see MB_Region
+ *                   addr - first item, count - number of items, dst - output
+ * Return value: none
+ */
+static void MB_Read_Ram(uint8_t space, const void *data, uint16_t addr, uint16_t count, uint8_t *dst)
+{
+    const uint16_t *p;
+    uint16_t i;
+
+    if (MB_SPACE_IS_BITS(space))
+    {
+        MB_Read_Bits((const uint32_t *) data, addr, count, dst);
+        return;
+    }
+
+    p = (const uint16_t *) data + addr;
+    for (i = 0; i < count; i++)
+    {
+        *dst++ = p[i];                              // Low byte
+        *dst++ = p[i] >> 8;                         // High byte
+    }
+}
+
+/*********************************************************************
+ * Function: read an address range from the register map
+ * Input parameters: space - MB_SPACE_xxx, addr - first address, count - number of items
+ *                   dst - output in wire format, see ModbusMap.h
+ * Return value: 0, or the Modbus exception code to answer with
+ * Description: The range must lie in one region, otherwise exception 02. A bank is
+ *              copied from its published buffer, the copy is good unless the writer got
+ *              round to that buffer again (Seq moved on by more than 2) while it was made.
+ *              A writer that keeps it from succeeding MB_BANK_RETRY_NUM times gets the
+ *              client exception 06, it is never stopped.
+ */
+uint8_t MB_Map_Read(uint8_t space, uint16_t addr, uint16_t count, uint8_t *dst)
+{
+    const MB_Region *r = MB_Map_Find(space, addr, count);
+    const MB_Bank *b;
+    uint32_t seq;
+    uint8_t n;
+
+    if (r == NULL)
+        return 0x02;                                // Illegal data address
+
+    addr -= r->Start;
+    if (r->Data == NULL)
+        return r->Read(addr, count, dst);
+
+    if (!(r->Flags & MB_REGION_BANK))
+    {
+        MB_Read_Ram(space, r->Data, addr, count, dst);
+        return 0;
+    }
+
+    b = (const MB_Bank *) r->Data;
+    for (n = 0; n < MB_BANK_RETRY_NUM; n++)
+    {
+        seq = b->Seq & ~1UL;                        // Last publish
+        MB_BARRIER();
+        MB_Read_Ram(space, b->Buf[(seq >> 1) & 1], addr, count, dst);
+        MB_BARRIER();
+        if (b->Seq - seq <= 2)                      // Not rewritten meanwhile
+            return 0;
+    }
+    return 0x06;                                    // Server device busy
+}
+
+/*********************************************************************
+ * Function: write an address range of the register map
+ * Input parameters: space - MB_SPACE_xxx, addr - first address, count - number of items
+ *                   src - input in wire format, see ModbusMap.h
+ * Return value: 0, or the Modbus exception code to answer with
+ * Description: The range must lie in one writable region, otherwise exception 02.
+ *              Registers of a MB_REGION_JOURNAL region that change are journaled.
+ */
+uint8_t MB_Map_Write(uint8_t space, uint16_t addr, uint16_t count, const uint8_t *src)
+{
+    const MB_Region *r = MB_Map_Find(space, addr, count);
+    uint16_t *p;
+    uint16_t i, v;
+
+    if (r == NULL)
+        return 0x02;                                // Illegal data address
+
+    addr -= r->Start;
+    if (r->Data == NULL)
+        return (r->Write != NULL) ? r->Write(addr, count, src) : 0x02;
+    if (r->Flags & (MB_REGION_RO | MB_REGION_BANK))
+        return 0x02;
+
+    if (MB_SPACE_IS_BITS(space))
+    {
+        MB_Write_Bits((uint32_t *) r->Data, addr, count, src);
+        return 0;
+    }
+
+    p = (uint16_t *) r->Data + addr;
+    for (i = 0; i < count; i++)
+    {
+        v = src[0] | (src[1] << 8);                 // Low byte first
+        if ((r->Flags & MB_REGION_JOURNAL) && (p[i] != v))
+            MB_Journal_Log(space, r->Start + addr + i, v);
+        p[i] = v;
+        src += 2;
+    }
+    return 0;
+}
+
+/*********************************************************************
+ * Function: start a refresh of a bank
+ * Input parameters: b - bank
+ * Return value: the copy to refresh, it holds the published values
+ * Description: Seq goes odd, readers stay on the published copy. Call MB_Bank_Publish
+ *              when done, one refresh at a time per bank. Costs one copy of the bank,
+ *              so a refresh may change just some of the values.
+ */
+void *MB_Bank_Begin(MB_Bank *b)
+{
+    uint32_t seq = b->Seq;
+    void *back = b->Buf[((seq >> 1) + 1) & 1];
+
+    b->Seq = seq + 1;
+    MB_BARRIER();
+    memcpy(back, b->Buf[(seq >> 1) & 1], b->Size);
+    return back;
+}
+
+/*********************************************************************
+ * Function: publish a refreshed bank
+ * Input parameters: b - bank
+ * Return value: none
+ * Description: Seq goes even, the copy returned by MB_Bank_Begin is read from now on.
+ */
+void MB_Bank_Publish(MB_Bank *b)
+{
+    MB_BARRIER();
+    b->Seq = b->Seq + 1;
+}
+
+/*********************************************************************
+ * Function: journal the registers the last publish of a bank changed
+ * Input parameters: b - register bank, space - MB_SPACE_xxx, start - address of its
+ *                   first register, count - number of registers compared
+ * Return value: none
+ * Description: Compares the published copy with the previous one, call it after
+ *              MB_Bank_Publish and before the next MB_Bank_Begin, from the main loop.
+ */
+void MB_Bank_Journal(const MB_Bank *b, uint8_t space, uint16_t start, uint16_t count)
+{
+    uint32_t seq = b->Seq;
+
+    MB_Journal_Diff(space, start, (const uint16_t *) b->Buf[((seq >> 1) + 1) & 1],
+                    (const uint16_t *) b->Buf[(seq >> 1) & 1], count);
+}
+
+/********************************* END OF FILE ************************************/
@@ -0,0 +1,88 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusMap.h
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus register map, regions of coils, discrete inputs, holding
+ *               and input registers backed by RAM arrays or by callbacks.
+*********************************************************************************/
+
+#ifndef __MODBUSMAP_H__
+#define __MODBUSMAP_H__
+
+/* Include header file ----------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Macro definition --------------------------------------------------------------------*/
+#define MB_SPACE_COILS      0  // FC01 read, FC05/FC15 write, 1 bit each
+#define MB_SPACE_DISCRETE   1  // FC02 read, 1 bit each
+#define MB_SPACE_HOLDING    2  // FC03 read, FC06/FC16 write, 2 bytes each
+#define MB_SPACE_INPUT      3  // FC04 read, 2 bytes each
+#define MB_SPACE_NUM        4
+
+#define MB_SPACE_IS_BITS(s) ((s) <= MB_SPACE_DISCRETE)
+
+#define MB_REGION_RO        0x01 // RAM region, Modbus writes are refused
+#define MB_REGION_BANK      0x02 // Data is an MB_Bank, Modbus writes are refused
+#define MB_REGION_JOURNAL   0x04 // Register region, changes go to the journal (ModbusJournal.h):
+                                 // Modbus writes of a RAM region, MB_Bank_Journal for a bank
+
+#define MB_BANK_RETRY_NUM   4    // Copies of a bank read before it fails with exception 06
+
+/* Type definition ------------------------------------------------------------------*/
+/*
+ * Region callbacks work on the data as it is on the wire: bits packed 8 per byte,
+ * bit 0 of the range in bit 0 of the first byte, registers 2 bytes each, low byte
+ * first. offset is relative to the region start, offset + count is inside the region.
+ * Return 0, or a Modbus exception code (e.g. 0x04) that is sent back to the client.
+ */
+typedef uint8_t (*MB_ReadFn)(uint16_t offset, uint16_t count, uint8_t *dst);
+typedef uint8_t (*MB_WriteFn)(uint16_t offset, uint16_t count, const uint8_t *src);
+
+typedef struct
+{
+    uint16_t Start;     // First address of the region
+    uint16_t Count;     // Number of bits or registers
+    uint8_t Flags;      // MB_REGION_RO
+    void *Data;         // RAM backing: uint16_t[Count] or 4 byte aligned packed bits, whole
+                        // 32-bit words, or with MB_REGION_BANK an MB_Bank of two such copies.
+                        // NULL when the region is served by the callbacks
+    MB_ReadFn Read;     // Used when Data is NULL
+    MB_WriteFn Write;   // Used when Data is NULL, NULL means read only
+} MB_Region;
+
+/*
+ * Double buffered bank for values the application refreshes while clients read them,
+ * e.g. 32-bit or float measurements split over two registers. The application fills
+ * the copy between MB_Bank_Begin and MB_Bank_Publish, clients read the other one and
+ * check Seq afterwards, so a read never returns half of one refresh and half of the
+ * next. Neither side disables interrupts or waits for the other.
+ */
+typedef struct
+{
+    volatile uint32_t Seq;  // Even: Buf[(Seq >> 1) & 1] is published, odd: the other one is being written
+    void *Buf[2];           // The two copies, same layout as a RAM region's Data
+    uint16_t Size;          // Bytes per copy
+} MB_Bank;
+
+typedef struct
+{
+    const MB_Region *Regions; // Sorted by Start, not overlapping
+    uint8_t Num;
+} MB_Table;
+
+/* Extended variables ------------------------------------------------------------------*/
+extern const MB_Table MB_Map[MB_SPACE_NUM]; // Provided by the application (User/ModbusRegs.c)
+
+/* Function declaration ------------------------------------------------------------------*/
+uint8_t MB_Map_Check(void);                                                              // 0 if MB_Map is usable
+const MB_Region *MB_Map_Find(uint8_t space, uint16_t addr, uint16_t count);            // Region holding the range, or NULL
+uint8_t MB_Map_Read(uint8_t space, uint16_t addr, uint16_t count, uint8_t *dst);         // 0 or exception code
+uint8_t MB_Map_Write(uint8_t space, uint16_t addr, uint16_t count, const uint8_t *src);  // 0 or exception code
+void *MB_Bank_Begin(MB_Bank *b);                                                         // Copy to refresh, holds the published values
+void MB_Bank_Publish(MB_Bank *b);                                                        // Make the refreshed copy the published one
+void MB_Bank_Journal(const MB_Bank *b, uint8_t space, uint16_t start, uint16_t count);   // Journal what the last publish changed
+
+#endif
+
+/********************************* END OF FILE ************************************/
@@ -0,0 +1,397 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusRTU.c
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus RTU master on USART2. A request is sent by DMA1 channel 7
+ *               straight from its queue entry, the response is received by DMA1
+ *               channel 6. MB_RTU_Poll only looks at the DMA counters and flags,
+ *               so the main loop never waits for the bus: frame ends and the
+ *               gaps between frames are 3.5 character times of silence timed
+ *               with the 1 ms SysTick, responses are checked with compute_crc16.
+ *               Requesters (flows, e.g. Modbus TCP clients) share the bus in turns,
+ *               each with at most MB_RTU_FLOW_MAX requests queued, and a request
+ *               that waited MB_RTU_QUEUE_MS is dropped, so one busy flow cannot
+ *               hold the others back.
+*********************************************************************************/
+/* Include header files ----------------------------------------------------------------*/
+#include <stddef.h>
+#include <string.h>
+#include "debug.h"
+#include "CRC16.h"
+#include "ModbusRTU.h"
+
+/* Private macro definition ----------------------------------------------------------------*/
+#define RTU_IDLE        0   // Bus states
+#define RTU_TX          1   // Request being sent
+#define RTU_RX          2   // Waiting for the response
+#define RTU_BROADCAST   3   // Turnaround delay after a broadcast
+
+#define RTU_TX_DMA      DMA1_Channel7
+#define RTU_RX_DMA      DMA1_Channel6
+
+/* Private type definition ----------------------------------------------------------------*/
+typedef struct
+{
+    uint8_t Used;                   // Entry in use
+    uint8_t Prio;                   // MB_RTU_PRIO_xxx
+    uint8_t Flow;                   // Requester
+    uint8_t Raw;                    // Sent as it is, no response expected
+    uint16_t Len;                   // ADU length
+    uint32_t Seq;                   // Order of submission
+    uint32_t Time;                  // RTU_Ms of submission
+    MB_RTU_DoneFn Done;             // Completion callback
+    uint16_t Tag;                   // Passed back to Done
+    uint8_t Adu[MB_RTU_ADU_MAX];    // Unit id + PDU + CRC, sent from here
+} RTU_Request;
+
+/* Private variable ------------------------------------------------------------------*/
+static RTU_Request RTU_Queue[MB_RTU_QUEUE_NUM];
+static RTU_Request *RTU_Cur;                    // Request on the bus
+static uint8_t RTU_Rx[MB_RTU_ADU_MAX];          // Response, written by DMA
+static uint8_t RTU_State;
+static uint16_t RTU_RxNum;                      // Response bytes seen so far
+static uint32_t RTU_Seq;
+static uint8_t RTU_Flow;                        // Flow sent last
+static uint32_t RTU_Time;                       // RTU_Ms of the last bus activity
+static volatile uint32_t RTU_Ms;                // 1 ms time base
+MB_RTU_Stat MB_RTU_Stats;
+
+/*********************************************************************
+ * Function: Initialize USART2 and its DMA channels
+ * Input parameter: None
+ * Return value: None
+ * Description: Pins PA2 (TX) and PA3 (RX) are set up by USART_Printf_Init, the
+ *              receiver is enabled here. Both DMA channels stay configured, each
+ *              transfer only rewrites the address and the counter.
+ */
+void MB_RTU_Init(void)
+{
+    USART_InitTypeDef USART_InitStructure = { 0 };
+    DMA_InitTypeDef DMA_InitStructure = { 0 };
+#ifdef MB_RTU_DE_PIN
+    GPIO_InitTypeDef GPIO_InitStructure = { 0 };
+
+    GPIO_InitStructure.GPIO_Pin = MB_RTU_DE_PIN;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
+    GPIO_Init(MB_RTU_DE_PORT, &GPIO_InitStructure);
+    GPIO_ResetBits(MB_RTU_DE_PORT, MB_RTU_DE_PIN);
+#endif
+
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART2, ENABLE);
+
+    USART_InitStructure.USART_BaudRate = MB_RTU_BAUD;
+    USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+    USART_InitStructure.USART_StopBits = USART_StopBits_1;
+    USART_InitStructure.USART_Parity = USART_Parity_No;
+    USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+    USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
+    USART_Init(USART2, &USART_InitStructure);
+
+    DMA_DeInit(RTU_TX_DMA);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) &USART2->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t) RTU_Queue[0].Adu;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 0;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(RTU_TX_DMA, &DMA_InitStructure);
+
+    DMA_DeInit(RTU_RX_DMA);
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t) RTU_Rx;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = MB_RTU_ADU_MAX;
+    DMA_Init(RTU_RX_DMA, &DMA_InitStructure);
+
+    USART_DMACmd(USART2, USART_DMAReq_Tx | USART_DMAReq_Rx, ENABLE);
+    USART_Cmd(USART2, ENABLE);
+
+    RTU_State = RTU_IDLE;
+    RTU_Time = RTU_Ms;
+}
+
+/*********************************************************************
+ * Function: Take a queue entry
+ * Input parameters: prio - MB_RTU_PRIO_xxx, flow - requester
+ * Return value: Entry, in use and without a callback, NULL if the queue or the
+ *               flow's share of it is full
+ */
+static RTU_Request *RTU_Alloc(uint8_t prio, uint8_t flow)
+{
+    RTU_Request *r = NULL;
+    uint8_t i, n = 0;
+
+    for (i = 0; i < MB_RTU_QUEUE_NUM; i++)
+    {
+        if (!RTU_Queue[i].Used)
+            r = &RTU_Queue[i];
+        else if (RTU_Queue[i].Flow == flow)
+            n++;
+    }
+    if ((r == NULL) || (n >= MB_RTU_FLOW_MAX))
+        return NULL;
+
+    memset(r, 0, offsetof(RTU_Request, Adu));
+    r->Prio = prio;
+    r->Flow = flow;
+    r->Seq = RTU_Seq++;
+    r->Time = RTU_Ms;
+    r->Used = 1;
+    return r;
+}
+
+/*********************************************************************
+ * Function: Queue a request
+ * Input parameters: prio - MB_RTU_PRIO_xxx, flow - requester, unit - unit id, 0 for
+ *                   a broadcast, pdu/len - request PDU, copied, done/tag - completion callback
+ * Return value: 0, or the Modbus exception code to answer with: 03 if the PDU does
+ *               not fit an RTU frame, 06 if the queue or the flow's share of it is full
+ */
+uint8_t MB_RTU_Submit(uint8_t prio, uint8_t flow, uint8_t unit, const uint8_t *pdu, uint16_t len,
+                      MB_RTU_DoneFn done, uint16_t tag)
+{
+    RTU_Request *r;
+    uint16_t crc;
+
+    if ((len == 0) || (len > MB_RTU_ADU_MAX - 3))
+        return 0x03;                                // Illegal data value
+
+    r = RTU_Alloc(prio, flow);
+    if (r == NULL)
+        return 0x06;                                // Server device busy
+
+    r->Adu[0] = unit;
+    memcpy(&r->Adu[1], pdu, len);
+    crc = compute_crc16(r->Adu, len + 1);
+    r->Adu[len + 1] = crc;                          // CRC low byte first
+    r->Adu[len + 2] = crc >> 8;
+    r->Len = len + 3;
+    r->Done = done;
+    r->Tag = tag;
+    return 0;
+}
+
+/*********************************************************************
+ * Function: Queue a frame that is not Modbus
+ * Input parameters: prio - MB_RTU_PRIO_xxx, flow - requester, buf/len - bytes to send, copied
+ * Return value: 0, 03 if it is longer than MB_RTU_ADU_MAX, 06 if the queue or the
+ *               flow's share of it is full
+ * Description: Sent between the Modbus frames, as it is. No response is waited for,
+ *              the bus is kept quiet for MB_RTU_TURNAROUND_MS after it, as after a
+ *              broadcast.
+ */
+uint8_t MB_RTU_Submit_Raw(uint8_t prio, uint8_t flow, const uint8_t *buf, uint16_t len)
+{
+    RTU_Request *r;
+
+    if ((len == 0) || (len > MB_RTU_ADU_MAX))
+        return 0x03;
+
+    r = RTU_Alloc(prio, flow);
+    if (r == NULL)
+        return 0x06;
+
+    memcpy(r->Adu, buf, len);
+    r->Len = len;
+    r->Raw = 1;
+    return 0;
+}
+
+/*********************************************************************
+ * Function: Complete a request
+ * Input parameters: r - request, pdu/len - response PDU, NULL if none
+ * Return value: None
+ * Description: The entry is freed before the callback, which may queue the next request.
+ */
+static void RTU_Complete(RTU_Request *r, const uint8_t *pdu, uint16_t len)
+{
+    MB_RTU_DoneFn done = r->Done;
+    uint16_t tag = r->Tag;
+
+    r->Used = 0;
+    if (done != NULL)
+        done(tag, pdu, len);
+}
+
+/*********************************************************************
+ * Function: Next request for the bus
+ * Input parameter: None
+ * Return value: Request to send, NULL if none
+ * Description: Requests queued for MB_RTU_QUEUE_MS are dropped first. Of the highest
+ *              priority, the flow after the one sent last goes next (round robin on
+ *              the flow number), and of that flow the request submitted first.
+ */
+static RTU_Request *RTU_Next(void)
+{
+    RTU_Request *r = NULL, *q;
+    uint8_t i;
+
+    for (i = 0; i < MB_RTU_QUEUE_NUM; i++)
+    {
+        q = &RTU_Queue[i];
+        if (!q->Used)
+            continue;
+        if (RTU_Ms - q->Time > MB_RTU_QUEUE_MS)
+        {
+            MB_RTU_Stats.Dropped++;
+            RTU_Complete(q, NULL, 0);
+            continue;
+        }
+        if ((r == NULL) || (q->Prio < r->Prio) ||
+            ((q->Prio == r->Prio) && ((uint8_t)(q->Flow - RTU_Flow - 1) < (uint8_t)(r->Flow - RTU_Flow - 1))) ||
+            ((q->Prio == r->Prio) && (q->Flow == r->Flow) && ((int32_t)(q->Seq - r->Seq) < 0)))
+            r = q;
+    }
+    if (r != NULL)
+        RTU_Flow = r->Flow;
+    return r;
+}
+
+/*********************************************************************
+ * Function: Start receiving a response
+ * Input parameter: None
+ * Return value: None
+ * Description: Whatever the receiver holds (the echo of the request on a two wire
+ *              bus, an overrun) is dropped before the DMA channel is restarted.
+ */
+static void RTU_Listen(void)
+{
+    DMA_Cmd(RTU_RX_DMA, DISABLE);
+    USART_GetFlagStatus(USART2, USART_FLAG_ORE);
+    USART_ReceiveData(USART2);
+    DMA_SetCurrDataCounter(RTU_RX_DMA, MB_RTU_ADU_MAX);
+    DMA_Cmd(RTU_RX_DMA, ENABLE);
+    RTU_RxNum = 0;
+}
+
+/*********************************************************************
+ * Function: Finish the request on the bus
+ * Input parameters: pdu/len - response PDU, NULL if none
+ * Return value: None
+ */
+static void RTU_Finish(const uint8_t *pdu, uint16_t len)
+{
+    RTU_Request *r = RTU_Cur;
+
+    DMA_Cmd(RTU_RX_DMA, DISABLE);
+    RTU_Cur = NULL;
+    RTU_State = RTU_IDLE;
+    RTU_Time = RTU_Ms;
+    RTU_Complete(r, pdu, len);
+}
+
+/*********************************************************************
+ * Function: Check a received response
+ * Input parameter: n - bytes received
+ * Return value: 1 if RTU_Rx holds a response to RTU_Cur
+ */
+static uint8_t RTU_Valid(uint16_t n)
+{
+    uint16_t crc;
+
+    if (n < 4)                                      // Unit id, function code, CRC
+        return 0;
+    crc = compute_crc16(RTU_Rx, n - 2);
+    return (RTU_Rx[n - 2] == (uint8_t) crc) && (RTU_Rx[n - 1] == (uint8_t)(crc >> 8)) &&
+           (RTU_Rx[0] == RTU_Cur->Adu[0]) && ((RTU_Rx[1] & 0x7F) == RTU_Cur->Adu[1]);
+}
+
+/*********************************************************************
+ * Function: Run the bus
+ * Input parameter: None
+ * Return value: None
+ * Description: One step of the bus state machine, returns straight away when
+ *              there is nothing to do yet.
+ */
+void MB_RTU_Poll(void)
+{
+    uint16_t n;
+
+    switch (RTU_State)
+    {
+        case RTU_IDLE:
+            if (RTU_Ms - RTU_Time < MB_RTU_T35_MS)    // Gap between frames
+                break;
+            RTU_Cur = RTU_Next();
+            if (RTU_Cur == NULL)
+                break;
+
+#ifdef MB_RTU_DE_PIN
+            GPIO_SetBits(MB_RTU_DE_PORT, MB_RTU_DE_PIN);
+#endif
+            DMA_Cmd(RTU_TX_DMA, DISABLE);
+            DMA_ClearFlag(DMA1_FLAG_TC7);
+            USART_ClearFlag(USART2, USART_FLAG_TC);
+            RTU_TX_DMA->MADDR = (uint32_t) RTU_Cur->Adu;
+            DMA_SetCurrDataCounter(RTU_TX_DMA, RTU_Cur->Len);
+            DMA_Cmd(RTU_TX_DMA, ENABLE);
+            MB_RTU_Stats.Requests++;
+            RTU_State = RTU_TX;
+            break;
+
+        case RTU_TX:                                  // Last stop bit out
+            if ((DMA_GetFlagStatus(DMA1_FLAG_TC7) == RESET) || (USART_GetFlagStatus(USART2, USART_FLAG_TC) == RESET))
+                break;
+#ifdef MB_RTU_DE_PIN
+            GPIO_ResetBits(MB_RTU_DE_PORT, MB_RTU_DE_PIN);
+#endif
+            RTU_Listen();
+            RTU_Time = RTU_Ms;
+            RTU_State = (RTU_Cur->Raw || (RTU_Cur->Adu[0] == 0)) ? RTU_BROADCAST : RTU_RX;
+            break;
+
+        case RTU_BROADCAST:                           // No response, give the devices time (also after a raw frame)
+            if (RTU_Ms - RTU_Time >= MB_RTU_TURNAROUND_MS)
+                RTU_Finish(NULL, 0);
+            break;
+
+        case RTU_RX:
+            n = MB_RTU_ADU_MAX - DMA_GetCurrDataCounter(RTU_RX_DMA);
+            if (n != RTU_RxNum)                       // Still receiving
+            {
+                RTU_RxNum = n;
+                RTU_Time = RTU_Ms;
+            }
+            else if (n == 0)
+            {
+                if (RTU_Ms - RTU_Time > MB_RTU_TIMEOUT_MS)
+                {
+                    MB_RTU_Stats.Timeouts++;
+                    RTU_Finish(NULL, 0);
+                }
+            }
+            else if (RTU_Ms - RTU_Time >= MB_RTU_T35_MS) // End of frame
+            {
+                if (RTU_Valid(n))
+                {
+                    MB_RTU_Stats.Responses++;
+                    RTU_Finish(&RTU_Rx[1], n - 3);
+                }
+                else
+                {
+                    MB_RTU_Stats.Errors++;
+                    RTU_Finish(NULL, 0);
+                }
+            }
+            break;
+    }
+}
+
+/*********************************************************************
+ * Function: Time base
+ * Input parameter: timperiod - ms since the last call
+ * Return value: None
+ */
+void MB_RTU_TimeIsr(uint16_t timperiod)
+{
+    RTU_Ms += timperiod;
+}
+
+/********************************* END OF FILE ************************************/
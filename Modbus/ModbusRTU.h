@@ -0,0 +1,66 @@
+/****************************** (C) COPYRIGHT ***********************************
+ * File Name : ModbusRTU.h
+ * Author : Nedelcu Bogdan Sebastian
+ * Version : V1.0.0
+ * Date : 17-October-2026
+ * Description : Modbus RTU master on USART2 (RS-485), DMA transfers and a request
+ *               queue served from the main loop.
+*********************************************************************************/
+
+#ifndef __MODBUSRTU_H__
+#define __MODBUSRTU_H__
+
+/* Include header file ----------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Macro definition --------------------------------------------------------------------*/
+#define MB_RTU_BAUD            115200  // USART2, 8 data bits, no parity, 1 stop bit
+#define MB_RTU_QUEUE_NUM       8       // Requests waiting for the bus
+#define MB_RTU_FLOW_MAX        3       // Requests of one flow in the queue at the same time
+#define MB_RTU_QUEUE_MS        500     // A request still queued after this is dropped
+#define MB_RTU_TIMEOUT_MS      100     // Response timeout
+#define MB_RTU_TURNAROUND_MS   100     // Bus kept quiet after a broadcast (unit id 0)
+#define MB_RTU_ADU_MAX         256     // Unit id + PDU 253 + CRC
+// #define MB_RTU_DE_PORT      GPIOA   // RS-485 driver enable, high while sending. Leave
+// #define MB_RTU_DE_PIN       GPIO_Pin_1 // undefined for auto direction transceivers
+
+#define MB_RTU_PRIO_HIGH       0       // Request priorities, lower is served first. Flows of
+#define MB_RTU_PRIO_NORMAL     1       // the same priority take turns, the requests of a flow
+#define MB_RTU_PRIO_LOW        2       // are sent in order
+
+// 3.5 character times of silence delimit a frame, fixed 1.75 ms above 19200 baud.
+// In whole ms of the 1 ms tick, plus one for the tick the measurement started in.
+#define MB_RTU_T35_MS          ((MB_RTU_BAUD > 19200) ? 3 : ((38500 + MB_RTU_BAUD - 1) / MB_RTU_BAUD + 1))
+
+/* Type definition ------------------------------------------------------------------*/
+/*
+ * Called once per request from MB_RTU_Poll: pdu is the response PDU (function code +
+ * data, exception responses included), len bytes, valid during the call. pdu is NULL
+ * if there is no valid response: timeout, CRC or framing error, dropped after
+ * MB_RTU_QUEUE_MS in the queue, or after a broadcast.
+ */
+typedef void (*MB_RTU_DoneFn)(uint16_t tag, const uint8_t *pdu, uint16_t len);
+
+typedef struct
+{
+    uint32_t Requests;          // Requests sent
+    uint32_t Responses;         // Valid responses
+    uint32_t Timeouts;          // No response within MB_RTU_TIMEOUT_MS
+    uint32_t Errors;            // Bad CRC, unit id or function code, too short
+    uint32_t Dropped;           // Not sent within MB_RTU_QUEUE_MS
+} MB_RTU_Stat;
+
+/* Extended variables ------------------------------------------------------------------*/
+extern MB_RTU_Stat MB_RTU_Stats;
+
+/* Function declaration ------------------------------------------------------------------*/
+void MB_RTU_Init(void);                 // USART2 and its DMA channels
+uint8_t MB_RTU_Submit(uint8_t prio, uint8_t flow, uint8_t unit, const uint8_t *pdu, uint16_t len,
+                      MB_RTU_DoneFn done, uint16_t tag); // Queue a request, 0 or exception code
+uint8_t MB_RTU_Submit_Raw(uint8_t prio, uint8_t flow, const uint8_t *buf, uint16_t len); // Queue a frame sent as it is
+void MB_RTU_Poll(void);                 // Run the bus, call from the main loop
+void MB_RTU_TimeIsr(uint16_t timperiod); // Time base, call from the 1 ms SysTick interrupt
+
+#endif
+
+/********************************* END OF FILE ************************************/
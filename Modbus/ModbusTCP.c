@@ -14,473 +14,781 @@
 #include "net_config.h"
 #include "wchnet.h"
 #include "ModbusTCP.h"
+#include "ModbusMap.h"
+#include "ModbusDevId.h"
+#include "ModbusGateway.h"
+#include "ModbusJournal.h"
 
 /*
     Read:
         01: Coils (FC=01)
+        02: Discrete Inputs (FC=02)
         03: Multiple Holding Registers (FC=03)
+        04: Input Registers (FC=04)
     Write:
         05: Single Coil (FC=05)
         06: Single Holding Register (FC=06)
         0F: Multiple Coils (FC=15)
         10: Multiple Holding Registers (FC=16)
+        16: Mask Write Holding Register (FC=22)
+    Read/Write:
+        17: Multiple Holding Registers (FC=23)
+    Encapsulated Interface Transport:
+        2B: Read Device Identification (FC=43, MEI=14)
+    User defined:
+        41: Read Changes (FC=65), the register changes since a sequence number
+            Request:  41, sequence number (4 bytes), max. number of changes (1 .. TCP_CHANGES_MAX)
+            Response: 41, byte count, next sequence number (4 bytes), status (MB_JOURNAL_xxx),
+                      9 bytes per change, see MB_Journal_Read
+            Sequence numbers go high byte first. A client starts with any number, gets
+            MB_JOURNAL_LOST and the current one, reads the registers in full once and
+            from then on only asks for the changes.
  */
 
 /* Private function declaration --------------------------------------------------------------*/
-void TCP_Exception_RSP(uint8_t socketid, uint8_t _FunCode, uint8_t _ExCode); // Fault response
-void MB_TCP_RSP(uint8_t socket_id, uint8_t _FunCode); //Normal response
-
-void TCP_RSP_01_02(uint8_t socketid); // FunCode 01 02 read switches
-void TCP_RSP_03_04(uint8_t socketid); // Function code 03 04 read registers
-void TCP_RSP_05(uint8_t socketid);    // Function code 05 write single output switching volume
-void TCP_RSP_06(uint8_t socketid);    // Function code 06 Write Single Holding Registers
-void TCP_RSP_0F(uint8_t socketid);    // Function code 15 Write multiple output switches
-void TCP_RSP_10(uint8_t socketid);    // Function code 16 Write multiple holding registers
+void TCP_Exception_RSP(MB_Session *s, uint8_t _FunCode, uint8_t _ExCode); // Fault response
+void MB_Parse_ADU(MB_Session *s); // Check and execute one request
+
+void TCP_RSP_01_02(MB_Session *s); // FunCode 01 02 read switches
+void TCP_RSP_03_04(MB_Session *s); // Function code 03 04 read registers
+void TCP_RSP_05(MB_Session *s);    // Function code 05 write single output switching volume
+void TCP_RSP_06(MB_Session *s);    // Function code 06 Write Single Holding Registers
+void TCP_RSP_0F(MB_Session *s);    // Function code 15 Write multiple output switches
+void TCP_RSP_10(MB_Session *s);    // Function code 16 Write multiple holding registers
+void TCP_RSP_16(MB_Session *s);    // Function code 22 Mask write holding register
+void TCP_RSP_17(MB_Session *s);    // Function code 23 Read/write multiple holding registers
+void TCP_RSP_2B(MB_Session *s);    // Function code 43 Read device identification
+void TCP_RSP_41(MB_Session *s);    // Function code 65 Read changes
+
+/* Private type definition ----------------------------------------------------------------*/
+typedef struct
+{
+    void (*Handler)(MB_Session *s);    // NULL: function code not supported, exception 01
+    uint8_t MinLen;                    // MBAP length field (station number + PDU) accepted,
+    uint8_t MaxLen;                    // exception 03 outside MinLen .. MaxLen
+    uint8_t Stat;                      // Slot in MB_FunStats
+} MB_Function;
 
 /* Private macro definition ----------------------------------------------------------------*/
+// Handler run time in SysTick counts (HCLK), the counter reloads every millisecond
+#define MB_CYCLES()          ((uint32_t) SysTick->CNT)
+#define MB_CYCLES_RELOAD     ((uint32_t) SysTick->CMP + 1)
 
-/* Private variable ------------------------------------------------------------------*/
-uint8_t Rx_Buf[256]; // Receive buffer, 256 bytes max.
-uint8_t Tx_Buf[256]; // Transmit buffer, 256 bytes max.
+#define TCP_LEN_MAX          (TCP_ADU_MAX - 6) // Largest MBAP length field
 
-uint32_t P_TxCount = 0;               // Send character count
-uint16_t P_Addr, P_RegNum, P_ByteNum; // Register address, register count, byte count
+#if (TCP_TX_BUF_LEN < TCP_ADU_MAX)
+    #error "WCHNET_TCP_MSS Error,One Modbus TCP ADU must fit in one segment"
+#endif
 
-/* Extended variable ------------------------------------------------------------------*/
-extern uint8_t coil[100];  // Coils
-extern uint16_t mreg[100]; // Holding Registers
-extern uint8_t MODBUSDataBuffer[RECE_BUF_LEN]; // Used as receive buffer, max 800*2 bytes
+/* Private variable ------------------------------------------------------------------*/
+MB_Session MB_Sessions[TCP_SESSION_NUM]; // One per Modbus TCP connection
+uint32_t MB_TxSegmentsSaved;             // Responses that did not need a segment of their own
+
+// Function code -> handler, one lookup checks and dispatches a request
+static const MB_Function MB_Functions[256] = {
+    /*        Handler        MinLen  MaxLen       Stat */
+    [0x01] = { TCP_RSP_01_02, 6,      6,           1 },   // Read Multiple Coils
+    [0x02] = { TCP_RSP_01_02, 6,      6,           2 },   // Read Multiple Discrete Inputs
+    [0x03] = { TCP_RSP_03_04, 6,      6,           3 },   // Read Multiple Holding Registers
+    [0x04] = { TCP_RSP_03_04, 6,      6,           4 },   // Read Multiple Input Registers
+    [0x05] = { TCP_RSP_05,    6,      6,           5 },   // Write Single Coil
+    [0x06] = { TCP_RSP_06,    6,      6,           6 },   // Write Single Holding Register
+    [0x0F] = { TCP_RSP_0F,    7,      TCP_LEN_MAX, 7 },   // Write Multiple Coils
+    [0x10] = { TCP_RSP_10,    7,      TCP_LEN_MAX, 8 },   // Write Multiple Holding Registers
+    [0x16] = { TCP_RSP_16,    8,      8,           9 },   // Mask Write Holding Register
+    [0x17] = { TCP_RSP_17,    13,     TCP_LEN_MAX, 10 },  // Read/Write Multiple Holding Registers
+    [0x2B] = { TCP_RSP_2B,    5,      5,           11 },  // Read Device Identification
+    [0x41] = { TCP_RSP_41,    7,      7,           12 },  // Read Changes
+};                                                        // Other codes: NULL handler, Stat 0
+
+MB_FunStat MB_FunStats[TCP_FUN_STAT_NUM] = {              // Function code of each Stat slot
+    { .FunCode = 0x00 }, { .FunCode = 0x01 }, { .FunCode = 0x02 }, { .FunCode = 0x03 },
+    { .FunCode = 0x04 }, { .FunCode = 0x05 }, { .FunCode = 0x06 }, { .FunCode = 0x0F },
+    { .FunCode = 0x10 }, { .FunCode = 0x16 }, { .FunCode = 0x17 }, { .FunCode = 0x2B },
+    { .FunCode = 0x41 },
+};
 
 /* Private function prototype --------------------------------------------------------------*/
 
 /*********************************************************************
  * Function: read input/output coil (bit)
- * Input parameter: socketid - socket id.
+ * Input parameter: s - Modbus session.
  * Return value: none
- * Description: None
+ * Description: FC01 reads the coils, FC02 the discrete inputs of MB_Map.
  */
-void TCP_RSP_01_02(uint8_t socketid)
+void TCP_RSP_01_02(MB_Session *s)
 {
-    uint16_t A_Leng = 0, B_Leng = 0;
-    uint8_t i, x;
-    uint8_t data[1024];
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+    uint16_t P_ByteNum;
+    uint8_t ex;
 
-    if ((P_Addr + P_RegNum) < TCP_MAX)
+    if ((s->RegNum == 0) || (s->RegNum > TCP_READ_BITS_MAX))
     {
-        Tx_Buf[0] = MODBUSDataBuffer[0]; // Transaction identifier
-        Tx_Buf[1] = MODBUSDataBuffer[1]; // Transaction identifier
-        Tx_Buf[2] = MODBUSDataBuffer[2]; // Protocol identifier
-        Tx_Buf[3] = MODBUSDataBuffer[3]; // Protocol identifier
-
-        Tx_Buf[6] = MODBUSDataBuffer[6]; // Station number
-        Tx_Buf[7] = MODBUSDataBuffer[7]; // Function code
-        P_ByteNum = P_RegNum / 8;        // Byte number
-
-        if (P_RegNum % 8) P_ByteNum += 1; // Byte count +1 if there is a remainder in the bits
-        Tx_Buf[8] = P_ByteNum; // Return word count
-
-        // Special cases, such as when the starting address is 5 and the number of bits is 16,
-        // if you calculate the number of bytes according to P_ByteNum, you need to add 1 and
-        // take the data of the latter array to fill
-        // if((P_RegNum % 8==0) && (P_Addr!=0))
-        // {
-        // P_ByteNum += 1; // }
-        // }
-
-        if ((P_RegNum % 8 == 0) && (P_Addr % 8 != 0))
-        {
-            P_ByteNum += 1;
-        }
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x03);    // Illegal quantity
+        return;
+    }
 
-		A_Leng = P_Addr / 8; // Store according to the array position, calculate the starting position
-		B_Leng = P_Addr % 8; // Calculate bits
-
-		// Zero the array to be used and send the contents of the array
-		memset( & data[0], 0, 1024);
-		memset( & Tx_Buf[9], 0, P_ByteNum);
-
-		// Separate data placement, array number 1, 2 3, 4 5, 6 ....
-		// Two arrays to store the same data, to facilitate the following calculations
-		for (i = 0; i < P_ByteNum; i++)
-		{
-			data[2 * i + 1] = coil[A_Leng + i];
-			data[2 * i + 2] = coil[A_Leng + i];
-		}
-
-		// Assignment based on byte count
-		for (x = 0; x < P_ByteNum; x++)
-		{
-			// Fill one byte of content data at a time, but there will be an offset problem
-		    // Offset the array bits 1, 3, 5... etc. array bit offset, that is, the first two bytes
-			// of the first offset, if the offset address is zero, then no offset */
-			data[2 * x + 1] = data[2 * x + 1] >> B_Leng;
-
-			// First fill the offset data content, assuming offset two bits,
-			// then is still need to fill 6 bits of data content
-			for (i = 0; i < 8 - B_Leng; i++)
-			{
-				// Determine the first bit after offset, which is also the lowest bit
-				if ((data[2 * x + 1]) & 0x01)
-				{
-					Tx_Buf[9 + x] |= (1 << i);
-				}
-				// The for loop continues to judge after one bit offset
-				data[2 * x + 1] >>= 1;
-			}
-
-			// Since there is an offset, then we need to take the data content of the array with one bit higher
-			// to fill the data content after the last offset, totaling 8 bits and one byte
-			for (i = 0; i < B_Leng; i++)
-			{
-				// To judge the higher bit of data, we assume that the previous take data[1], here take data[4], data[6],
-				// because the next round of byte loop data[2*x+1] value is data[3], data[5] ...
-				// This does not affect the original data content when judging the assignment shift
-				if ((data[2 * x + 4]) & 0x01) {
-					Tx_Buf[9 + x] |= (1 << (8 + i - B_Leng));
-				}
-				data[2 * x + 4] >>= 1;
-			}
-		}
-
-		// Only if the read coil first address is not 0,8,16,... and the number of coils to be read is not an integer multiple of 8.
-		if(!((P_Addr%8 == 0)&&(P_RegNum%8 == 0)))
-		{
-			// Offset the high bit after zero
-			for(i=0;i<8-P_RegNum % 8;i++)
-			{
-			  Tx_Buf[8+P_ByteNum] &= ~(1 << (P_RegNum % 8+i));
-			}
-		}
-
-		P_ByteNum += 3;
-		Tx_Buf[4] = P_ByteNum >> 8;
-		Tx_Buf[5] = P_ByteNum;
-
-		P_TxCount=P_ByteNum+6;
-		WCHNET_SocketSend(socketid, Tx_Buf, &P_TxCount);           //Socket sends data.
-	}
+    ex = MB_Map_Read((Rx_Adu[7] == 0x01) ? MB_SPACE_COILS : MB_SPACE_DISCRETE, s->Addr, s->RegNum, &Tx_Adu[9]);
+    if (ex == 0)
+    {
+        Tx_Adu[0] = Rx_Adu[0]; // Transaction identifier
+        Tx_Adu[1] = Rx_Adu[1]; // Transaction identifier
+        Tx_Adu[2] = Rx_Adu[2]; // Protocol identifier
+        Tx_Adu[3] = Rx_Adu[3]; // Protocol identifier
+
+        Tx_Adu[6] = Rx_Adu[6]; // Station number
+        Tx_Adu[7] = Rx_Adu[7]; // Function code
+        P_ByteNum = (s->RegNum + 7) / 8;  // Byte number, last byte padded with zeros
+        Tx_Adu[8] = P_ByteNum;           // Return byte count
+
+        P_ByteNum += 3;
+        Tx_Adu[4] = P_ByteNum >> 8;
+        Tx_Adu[5] = P_ByteNum;
+
+        s->TxLen += P_ByteNum+6; // Queue for sending
+    }
     else
-        TCP_Exception_RSP(socketid, MODBUSDataBuffer[7], 0x02);    // Send error code
+        TCP_Exception_RSP(s, Rx_Adu[7], ex);      // Send error code
 }
 
 /*********************************************************************
  * Function: read input/output registers (1 register = 2 Bytes)
- * Input parameter: socketid - socket id.
+ * Input parameter: s - Modbus session.
  * Return value: None
- * Description: None
+ * Description: FC03 reads the holding registers, FC04 the input registers of MB_Map.
+ *              Also sends the read part of FC23, s->Addr/s->RegNum are then the read range.
  */
-void TCP_RSP_03_04(uint8_t socketid)
+void TCP_RSP_03_04(MB_Session *s)
 {
-    uint16_t i;
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+    uint16_t P_ByteNum;
+    uint8_t ex;
 
-    if ((P_Addr + P_RegNum) < TCP_MAX)
+    if ((s->RegNum == 0) || (s->RegNum > TCP_READ_REGS_MAX))
     {
-        Tx_Buf[0] = MODBUSDataBuffer[0];     // Transaction identifier
-        Tx_Buf[1] = MODBUSDataBuffer[1];     // Transaction identifier
-        Tx_Buf[2] = MODBUSDataBuffer[2];     // Protocol identifier
-        Tx_Buf[3] = MODBUSDataBuffer[3];     // Protocol identifier
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x03);    // Illegal quantity
+        return;
+    }
 
-        Tx_Buf[6] = MODBUSDataBuffer[6];     // Station number
-        Tx_Buf[7] = MODBUSDataBuffer[7];     // Function code
+    ex = MB_Map_Read((Rx_Adu[7] == 0x04) ? MB_SPACE_INPUT : MB_SPACE_HOLDING, s->Addr, s->RegNum, &Tx_Adu[9]);
+    if (ex == 0)
+    {
+        Tx_Adu[0] = Rx_Adu[0];     // Transaction identifier
+        Tx_Adu[1] = Rx_Adu[1];     // Transaction identifier
+        Tx_Adu[2] = Rx_Adu[2];     // Protocol identifier
+        Tx_Adu[3] = Rx_Adu[3];     // Protocol identifier
 
-        P_ByteNum = P_RegNum * 2;            // Byte number
-        Tx_Buf[8] = P_ByteNum;               // Number of bytes returned
+        Tx_Adu[6] = Rx_Adu[6];     // Station number
+        Tx_Adu[7] = Rx_Adu[7];     // Function code
 
-        for (i = 0; i<P_RegNum; i++)
-        {
-            Tx_Buf[9 + i * 2] = mreg[P_Addr + i];        // Low byte
-            Tx_Buf[10 + i * 2] = mreg[P_Addr + i] >> 8;  // High byte
-        }
-        P_ByteNum += 3;
-        Tx_Buf[4] = P_ByteNum >> 8;
-        Tx_Buf[5] = P_ByteNum;
+        P_ByteNum = s->RegNum * 2;            // Byte number
+        Tx_Adu[8] = P_ByteNum;               // Number of bytes returned
 
-        P_TxCount = P_ByteNum+6;
+        P_ByteNum += 3;
+        Tx_Adu[4] = P_ByteNum >> 8;
+        Tx_Adu[5] = P_ByteNum;
 
-        WCHNET_SocketSend(socketid, Tx_Buf, &P_TxCount);           //Socket sends data.
+        s->TxLen += P_ByteNum+6; // Queue for sending
     }
     else
     {
-        TCP_Exception_RSP(socketid, MODBUSDataBuffer[7], 0x02);    //Function code error response
-        printf(" === MBTCP Function code : %d \n", MODBUSDataBuffer[7]);
+        TCP_Exception_RSP(s, Rx_Adu[7], ex);      //Function code error response
+        printf(" === MBTCP Function code : %d \n", Rx_Adu[7]);
     }
 }
 
 /*********************************************************************
  * Function: Write a single coil
- * Input parameter: socketid - socket id.
+ * Input parameter: s - Modbus session.
  * Return value: none
- * Description: None
+ * Description: The output value is FF00 (ON) or 0000 (OFF), exception 03 otherwise.
  */
-void TCP_RSP_05(uint8_t socketid)
+void TCP_RSP_05(MB_Session *s)
 {
-    uint16_t A_Leng,B_Leng;
-    if (P_Addr < TCP_MAX)
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+    uint8_t on, ex;
+
+    if ((s->RegNum != 0xFF00) && (s->RegNum != 0x0000))
     {
-        Tx_Buf[0] = MODBUSDataBuffer[0];   // Transaction identifier
-        Tx_Buf[1] = MODBUSDataBuffer[1];   // Transaction identifier
-        Tx_Buf[2] = MODBUSDataBuffer[2];   // Protocol identifier
-        Tx_Buf[3] = MODBUSDataBuffer[3];   // Protocol identifier
-        Tx_Buf[4] = MODBUSDataBuffer[4];   // Later bytes
-        Tx_Buf[5] = MODBUSDataBuffer[5];   // Number of bytes to follow
-        Tx_Buf[6] = MODBUSDataBuffer[6];   // Station number
-        Tx_Buf[7] = MODBUSDataBuffer[7];   // Function code
-        Tx_Buf[8] = MODBUSDataBuffer[8];   // Write address
-        Tx_Buf[9] = MODBUSDataBuffer[9];   //
-        Tx_Buf[10] = MODBUSDataBuffer[10]; // Write content
-        Tx_Buf[11] = MODBUSDataBuffer[11]; //
-
-        A_Leng = P_Addr / 8; // Store according to array position, calculate start position
-        B_Leng = P_Addr % 8; // Calculate bits
-
-        if (MODBUSDataBuffer[10] == 0xff || MODBUSDataBuffer[11] == 0xff)
-        {
-            // Assign the value directly to the appropriate address
-            coil[A_Leng] |= 1<<B_Leng;
-            printf(" === Turning on coil\n");
-        }
-        else
-        {
-            // Directly assign the value to the corresponding address
-            coil[A_Leng] &= ~(1<<B_Leng);
-            // coil[P_Addr] = 0x00;
-            printf(" === Turning off coil.\n");
-        }
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x03);    // Output value is neither ON nor OFF
+        return;
+    }
 
-        P_TxCount=12;
-        WCHNET_SocketSend(socketid, Tx_Buf, &P_TxCount);           //Socket sends data.
+    on = (s->RegNum == 0xFF00);
+    ex = MB_Map_Write(MB_SPACE_COILS, s->Addr, 1, &on);
+    if (ex == 0)
+    {
+        Tx_Adu[0] = Rx_Adu[0];   // Transaction identifier
+        Tx_Adu[1] = Rx_Adu[1];   // Transaction identifier
+        Tx_Adu[2] = Rx_Adu[2];   // Protocol identifier
+        Tx_Adu[3] = Rx_Adu[3];   // Protocol identifier
+        Tx_Adu[4] = Rx_Adu[4];   // Later bytes
+        Tx_Adu[5] = Rx_Adu[5];   // Number of bytes to follow
+        Tx_Adu[6] = Rx_Adu[6];   // Station number
+        Tx_Adu[7] = Rx_Adu[7];   // Function code
+        Tx_Adu[8] = Rx_Adu[8];   // Write address
+        Tx_Adu[9] = Rx_Adu[9];   //
+        Tx_Adu[10] = Rx_Adu[10]; // Write content
+        Tx_Adu[11] = Rx_Adu[11]; //
+
+        printf(on ? " === Turning on coil\n" : " === Turning off coil.\n");
+
+        s->TxLen += 12; // Queue for sending
     }
     else
-        TCP_Exception_RSP(socketid, MODBUSDataBuffer[7], 0x02);    // Send error code
+        TCP_Exception_RSP(s, Rx_Adu[7], ex);      // Send error code
 }
 
 /*********************************************************************
  * Function: Write single register.
- * Input parameter: socketid - socket id.
+ * Input parameter: s - Modbus session.
  * Return value: none
  * Description: None
  */
-void TCP_RSP_06(uint8_t socketid)
+void TCP_RSP_06(MB_Session *s)
 {
-    if (P_Addr < TCP_MAX)
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+    uint8_t ex;
+
+    ex = MB_Map_Write(MB_SPACE_HOLDING, s->Addr, 1, &Rx_Adu[10]); // Low byte, high byte
+    if (ex == 0)
     {
-        Tx_Buf[0] = MODBUSDataBuffer[0];   // Transaction identifier
-        Tx_Buf[1] = MODBUSDataBuffer[1];   // Transaction identifier
-        Tx_Buf[2] = MODBUSDataBuffer[2];   // Protocol identifier
-        Tx_Buf[3] = MODBUSDataBuffer[3];   // Protocol identifier
-        Tx_Buf[4] = MODBUSDataBuffer[4];   // Later bytes
-        Tx_Buf[5] = MODBUSDataBuffer[5];   // Number of bytes to follow
-        Tx_Buf[6] = MODBUSDataBuffer[6];   // Station number
-        Tx_Buf[7] = MODBUSDataBuffer[7];   // Function code
-        Tx_Buf[8] = MODBUSDataBuffer[8];   // Write address
-        Tx_Buf[9] = MODBUSDataBuffer[9];   // Write address
-        Tx_Buf[10] = MODBUSDataBuffer[10]; // Write content
-        Tx_Buf[11] = MODBUSDataBuffer[11]; // Write content
-
-        mreg[P_Addr] = MODBUSDataBuffer[10];       // Low byte data written
-        mreg[P_Addr] |= MODBUSDataBuffer[11] << 8; // High byte data write
-
-        P_TxCount = 12; // High byte data write
-
-        WCHNET_SocketSend(socketid, Tx_Buf, & P_TxCount);       // Socket sends data
+        Tx_Adu[0] = Rx_Adu[0];   // Transaction identifier
+        Tx_Adu[1] = Rx_Adu[1];   // Transaction identifier
+        Tx_Adu[2] = Rx_Adu[2];   // Protocol identifier
+        Tx_Adu[3] = Rx_Adu[3];   // Protocol identifier
+        Tx_Adu[4] = Rx_Adu[4];   // Later bytes
+        Tx_Adu[5] = Rx_Adu[5];   // Number of bytes to follow
+        Tx_Adu[6] = Rx_Adu[6];   // Station number
+        Tx_Adu[7] = Rx_Adu[7];   // Function code
+        Tx_Adu[8] = Rx_Adu[8];   // Write address
+        Tx_Adu[9] = Rx_Adu[9];   // Write address
+        Tx_Adu[10] = Rx_Adu[10]; // Write content
+        Tx_Adu[11] = Rx_Adu[11]; // Write content
+
+        s->TxLen += 12; // Queue for sending
     } else
-        TCP_Exception_RSP(socketid, MODBUSDataBuffer[7], 0x02); // Send error code
+        TCP_Exception_RSP(s, Rx_Adu[7], ex);   // Send error code
 }
 
 /*********************************************************************
  * Function: write multiple coils (function code: 0x0F)
- * Input parameter: socketid - socket id.
+ * Input parameter: s - Modbus session.
  * Return value: none
  * Description: None
  */
-void TCP_RSP_0F(uint8_t socketid)
+void TCP_RSP_0F(MB_Session *s)
 {
-    uint8_t next_data[255];
-    uint16_t i, x;
-    uint16_t A_Leng, B_Leng;
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+    uint8_t ex;
 
-    if((P_Addr + P_RegNum) < TCP_MAX)
+    if ((s->RegNum == 0) || (s->RegNum > TCP_WRITE_BITS_MAX) || (Rx_Adu[12] != (s->RegNum + 7) / 8) ||
+        ((Rx_Adu[5] | Rx_Adu[4] << 8) != Rx_Adu[12] + 7))
     {
-        Tx_Buf[0] = MODBUSDataBuffer[0];   // Transaction identifier
-        Tx_Buf[1] = MODBUSDataBuffer[1];   // Transaction identifier
-        Tx_Buf[2] = MODBUSDataBuffer[2];   // Protocol identifier
-        Tx_Buf[3] = MODBUSDataBuffer[3];   // Protocol identifier
-        Tx_Buf[4] = 0;                     // Following bytes
-        Tx_Buf[5] = 6;                     // Number of bytes to follow
-        Tx_Buf[6] = MODBUSDataBuffer[6];   // Station number
-        Tx_Buf[7] = MODBUSDataBuffer[7];   // Function code
-        Tx_Buf[8] = MODBUSDataBuffer[8];   // Starting address
-        Tx_Buf[9] = MODBUSDataBuffer[9];   //
-        Tx_Buf[10] = MODBUSDataBuffer[10]; // Quantity
-        Tx_Buf[11] = MODBUSDataBuffer[11]; //
-
-        A_Leng = P_Addr / 8; // Store according to array position, calculate start position
-        B_Leng = P_Addr % 8; // Calculate bits
-
-        // memset(coil,0,MODBUSDataBuffer[12]+1); // Calculate bits; //Calculate bits
-
-        for (x = 0; x < MODBUSDataBuffer[12]; x++) // Write coil according to byte count
-        {
-            next_data[x] = MODBUSDataBuffer[13 + x];
-            // printf("---------------Rx_Buf[x]=%x\n",Rx_Buf[13+x]);
-            for (i = 0; i < (8 - B_Leng); i++) // Set coil (first address start)
-            {
-                if ((MODBUSDataBuffer[13 + x]) & 0x01) // Determine if the bit is valid or not
-                {
-                    coil[A_Leng + x] |= (1 << (i % 8)) << B_Leng; // Assign value from offset address, offset address is B_Leng
-                    //printf("1---r[%d]=%x\n",i,coil[A_Leng+x]);
-                } else {
-                    coil[A_Leng + x] &= ~((1 << (i % 8)) << B_Leng); // Corresponding bit clearing
-                }
-                MODBUSDataBuffer[13 + x] >>= 1; // Continue to determine the next bit
-            }
-
-            for (i = 0; i < B_Leng; i++) // Set coil (remaining bits set)
-            {
-                if ((next_data[x] >> (8 - B_Leng)) & 0x01) // Continue to process the remaining data according to the previous judgment
-                {
-                    coil[A_Leng + x + 1] |= 1 << (i % 8); // Remaining bits are assigned to set bits
-                    //printf("3---r[%d]=%x\n",i,coil[A_Leng+x+1]);
-                } else {
-                    coil[A_Leng + x + 1] &= ~(1 << (i % 8)); // Corresponding bit clearing
-                }
-                next_data[x] >>= 1;
-            }
-        }
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x03);    // Illegal quantity or byte count
+        return;
+    }
 
-        P_TxCount = 12;
-        WCHNET_SocketSend(socketid, Tx_Buf, & P_TxCount); // Socket sends data.
+    ex = MB_Map_Write(MB_SPACE_COILS, s->Addr, s->RegNum, &Rx_Adu[13]); // Only the requested bits change
+    if (ex == 0)
+    {
+        Tx_Adu[0] = Rx_Adu[0];   // Transaction identifier
+        Tx_Adu[1] = Rx_Adu[1];   // Transaction identifier
+        Tx_Adu[2] = Rx_Adu[2];   // Protocol identifier
+        Tx_Adu[3] = Rx_Adu[3];   // Protocol identifier
+        Tx_Adu[4] = 0;                     // Following bytes
+        Tx_Adu[5] = 6;                     // Number of bytes to follow
+        Tx_Adu[6] = Rx_Adu[6];   // Station number
+        Tx_Adu[7] = Rx_Adu[7];   // Function code
+        Tx_Adu[8] = Rx_Adu[8];   // Starting address
+        Tx_Adu[9] = Rx_Adu[9];   //
+        Tx_Adu[10] = Rx_Adu[10]; // Quantity
+        Tx_Adu[11] = Rx_Adu[11]; //
+
+        s->TxLen += 12; // Queue for sending
     }
     else
-        TCP_Exception_RSP(socketid, MODBUSDataBuffer[7], 0x02); // Function code error response
+        TCP_Exception_RSP(s, Rx_Adu[7], ex); // Function code error response
 }
 
 /*********************************************************************
  * Function: Write multiple registers (function code: 0x10)
- * Input parameter: socketid - socket id.
+ * Input parameter: s - Modbus session.
  * Return value: none
  * Description: None
  */
-void TCP_RSP_10(uint8_t socketid) {
-    uint16_t i;
+void TCP_RSP_10(MB_Session *s)
+{
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+    uint8_t ex;
 
-	if ((P_Addr + P_RegNum) < TCP_MAX)
+    if ((s->RegNum == 0) || (s->RegNum > TCP_WRITE_REGS_MAX) || (Rx_Adu[12] != s->RegNum * 2) ||
+        ((Rx_Adu[5] | Rx_Adu[4] << 8) != Rx_Adu[12] + 7))
+    {
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x03);    // Illegal quantity or byte count
+        return;
+    }
+
+	ex = MB_Map_Write(MB_SPACE_HOLDING, s->Addr, s->RegNum, &Rx_Adu[13]); // Write to registers
+	if (ex == 0)
 	{
-		Tx_Buf[0] = MODBUSDataBuffer[0];   // Transaction identifier
-		Tx_Buf[1] = MODBUSDataBuffer[1];   // Transaction identifier
-		Tx_Buf[2] = MODBUSDataBuffer[2];   // Protocol identifier
-		Tx_Buf[3] = MODBUSDataBuffer[3];   // Protocol identifier
-		Tx_Buf[4] = 0;                     // Following bytes
-		Tx_Buf[5] = 6;                     // Number of bytes to follow
-		Tx_Buf[6] = MODBUSDataBuffer[6];   // Station number
-		Tx_Buf[7] = MODBUSDataBuffer[7];   // Function code
-		Tx_Buf[8] = MODBUSDataBuffer[8];   // Starting address
-		Tx_Buf[9] = MODBUSDataBuffer[9];   // Start address
-		Tx_Buf[10] = MODBUSDataBuffer[10]; // Quantity
-		Tx_Buf[11] = MODBUSDataBuffer[11]; // Quantity
-
-		for (i = 0; i < P_RegNum; i++) // Write to registers
-		{
-			mreg[P_Addr + i] = MODBUSDataBuffer[13 + i * 2]; // Low byte
-			mreg[P_Addr + i] |= MODBUSDataBuffer[14 + i * 2] << 8; // High byte
-		}
-		P_TxCount = 12;
-
-		WCHNET_SocketSend(socketid, Tx_Buf, & P_TxCount); // Socket sends data
+		Tx_Adu[0] = Rx_Adu[0];   // Transaction identifier
+		Tx_Adu[1] = Rx_Adu[1];   // Transaction identifier
+		Tx_Adu[2] = Rx_Adu[2];   // Protocol identifier
+		Tx_Adu[3] = Rx_Adu[3];   // Protocol identifier
+		Tx_Adu[4] = 0;                     // Following bytes
+		Tx_Adu[5] = 6;                     // Number of bytes to follow
+		Tx_Adu[6] = Rx_Adu[6];   // Station number
+		Tx_Adu[7] = Rx_Adu[7];   // Function code
+		Tx_Adu[8] = Rx_Adu[8];   // Starting address
+		Tx_Adu[9] = Rx_Adu[9];   // Start address
+		Tx_Adu[10] = Rx_Adu[10]; // Quantity
+		Tx_Adu[11] = Rx_Adu[11]; // Quantity
+
+		s->TxLen += 12; // Queue for sending
 	}
     else
-        TCP_Exception_RSP(socketid, MODBUSDataBuffer[7], 0x02); // Function code error response
+        TCP_Exception_RSP(s, Rx_Adu[7], ex); // Function code error response
+}
+
+/*********************************************************************
+ * Function: Mask write register (function code: 0x16)
+ * Input parameter: s - Modbus session.
+ * Return value: none
+ * Description: Register = (Register AND And_Mask) OR (Or_Mask AND (NOT And_Mask)).
+ *              The masks are applied byte by byte to the register as it is on the
+ *              wire, so they follow the same byte order as FC03/FC06 data.
+ */
+void TCP_RSP_16(MB_Session *s)
+{
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+    uint8_t reg[2], i, ex;
+
+    ex = MB_Map_Read(MB_SPACE_HOLDING, s->Addr, 1, reg);
+    if (ex == 0)
+    {
+        for (i = 0; i < 2; i++)
+            reg[i] = (reg[i] & Rx_Adu[10 + i]) | (Rx_Adu[12 + i] & ~Rx_Adu[10 + i]); // AND mask, OR mask
+        ex = MB_Map_Write(MB_SPACE_HOLDING, s->Addr, 1, reg);
+    }
+    if (ex == 0)
+    {
+        for (i = 0; i < 14; i++)               // Response is an echo of the request
+            Tx_Adu[i] = Rx_Adu[i];
+
+        s->TxLen += 14; // Queue for sending
+    }
+    else
+        TCP_Exception_RSP(s, Rx_Adu[7], ex); // Function code error response
+}
+
+/*********************************************************************
+ * Function: Read/write multiple registers (function code: 0x17)
+ * Input parameter: s - Modbus session.
+ * Return value: none
+ * Description: The write is done first, then the read is answered as FC03. Both
+ *              ranges are checked before anything is written.
+ */
+void TCP_RSP_17(MB_Session *s)
+{
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint16_t w_addr = (Rx_Adu[12] << 8) | Rx_Adu[13]; // Write starting address
+    uint16_t w_num = (Rx_Adu[14] << 8) | Rx_Adu[15];  // Quantity to write
+    uint8_t ex;
+
+    if ((s->RegNum == 0) || (s->RegNum > TCP_READ_REGS_MAX) ||
+        (w_num == 0) || (w_num > TCP_RW_WRITE_REGS_MAX) || (Rx_Adu[16] != w_num * 2) ||
+        ((Rx_Adu[5] | Rx_Adu[4] << 8) != Rx_Adu[16] + 11))
+    {
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x03);    // Illegal quantity or byte count
+        return;
+    }
+
+    if (MB_Map_Find(MB_SPACE_HOLDING, s->Addr, s->RegNum) == NULL)
+        ex = 0x02;                                // Read range, nothing is written
+    else
+        ex = MB_Map_Write(MB_SPACE_HOLDING, w_addr, w_num, &Rx_Adu[17]);
+
+    if (ex == 0)
+        TCP_RSP_03_04(s);                         // Read part, same response as FC03
+    else
+        TCP_Exception_RSP(s, Rx_Adu[7], ex);      // Function code error response
+}
+
+/*********************************************************************
+ * Function: Read device identification (function code: 0x2B, MEI type 0x0E)
+ * Input parameter: s - Modbus session.
+ * Return value: none
+ * Description: The objects come ready encoded from MB_DevId_Read, see ModbusDevId.c.
+ */
+void TCP_RSP_2B(MB_Session *s)
+{
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+    uint16_t len;
+    uint8_t ex;
+
+    if (Rx_Adu[8] != 0x0E)
+    {
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x01);    // Only MEI type 14 is served
+        return;
+    }
+
+    ex = MB_DevId_Read(Rx_Adu[9], Rx_Adu[10], &Tx_Adu[9], &len);
+    if (ex == 0)
+    {
+        Tx_Adu[0] = Rx_Adu[0]; // Transaction identifier
+        Tx_Adu[1] = Rx_Adu[1]; // Transaction identifier
+        Tx_Adu[2] = Rx_Adu[2]; // Protocol identifier
+        Tx_Adu[3] = Rx_Adu[3]; // Protocol identifier
+        Tx_Adu[4] = (len + 3) >> 8;      // Number of bytes to follow
+        Tx_Adu[5] = len + 3;             // Station number + function code + MEI type + data
+        Tx_Adu[6] = Rx_Adu[6]; // Station number
+        Tx_Adu[7] = Rx_Adu[7]; // Function code
+        Tx_Adu[8] = Rx_Adu[8]; // MEI type
+
+        s->TxLen += 9 + len; // Queue for sending
+    }
+    else
+        TCP_Exception_RSP(s, Rx_Adu[7], ex); // Function code error response
+}
+
+/*********************************************************************
+ * Function: Read changes
+ * Input parameter: s - Modbus session.
+ * Return value: None
+ * Description: The register changes journaled since the sequence number of the
+ *              request, at most as many as it asks for (ModbusJournal.c).
+ */
+void TCP_RSP_41(MB_Session *s)
+{
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+    uint32_t seq;
+    uint16_t P_ByteNum;
+    uint8_t num = Rx_Adu[12];
+
+    if ((num == 0) || (num > TCP_CHANGES_MAX))
+    {
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x03);    // Illegal quantity
+        return;
+    }
+
+    seq = ((uint32_t) Rx_Adu[8] << 24) | ((uint32_t) Rx_Adu[9] << 16) | (Rx_Adu[10] << 8) | Rx_Adu[11];
+    Tx_Adu[13] = MB_Journal_Read(&seq, &num, &Tx_Adu[14]); // Status
+    Tx_Adu[9] = seq >> 24;     // Next sequence number
+    Tx_Adu[10] = seq >> 16;
+    Tx_Adu[11] = seq >> 8;
+    Tx_Adu[12] = seq;
+
+    Tx_Adu[0] = Rx_Adu[0];     // Transaction identifier
+    Tx_Adu[1] = Rx_Adu[1];     // Transaction identifier
+    Tx_Adu[2] = Rx_Adu[2];     // Protocol identifier
+    Tx_Adu[3] = Rx_Adu[3];     // Protocol identifier
+
+    Tx_Adu[6] = Rx_Adu[6];     // Station number
+    Tx_Adu[7] = Rx_Adu[7];     // Function code
+
+    P_ByteNum = 5 + num * MB_JOURNAL_REC_LEN; // Sequence number, status, changes
+    Tx_Adu[8] = P_ByteNum;
+
+    P_ByteNum += 3;
+    Tx_Adu[4] = P_ByteNum >> 8;
+    Tx_Adu[5] = P_ByteNum;
+
+    s->TxLen += P_ByteNum+6; // Queue for sending
 }
 
 /*********************************************************************
  * Function: Exception Response
- * Input parameters: socketid - socket id,_FunCode :function code to send exception,_ExCode: exception code
+ * Input parameters: s - Modbus session,_FunCode :function code to send exception,_ExCode: exception code
  * Return value: None
  * Description: Send an exception response when an exception occurs in the communication data frame.
  */
-void TCP_Exception_RSP(uint8_t socketid, uint8_t _FunCode, uint8_t _ExCode)
+void TCP_Exception_RSP(MB_Session *s, uint8_t _FunCode, uint8_t _ExCode)
 {
-    Tx_Buf[0] = MODBUSDataBuffer[0]; // Transaction identifier
-    Tx_Buf[1] = MODBUSDataBuffer[1]; // Transaction identifier
-    Tx_Buf[2] = MODBUSDataBuffer[2]; // Protocol identifier
-    Tx_Buf[3] = MODBUSDataBuffer[3]; // Protocol identifier
-    Tx_Buf[4] = 0;                   // Following bytes
-    Tx_Buf[5] = 3;                   // Number of bytes to follow
-    Tx_Buf[6] = MODBUSDataBuffer[6]; // Station number
-    Tx_Buf[7] = _FunCode | 0x80;     // Function code
-    Tx_Buf[8] = _ExCode;             // Exception code
-
-    P_TxCount = 9;
-
-    WCHNET_SocketSend(socketid, Tx_Buf, & P_TxCount); // Socket sends data.
+    const uint8_t *Rx_Adu = s->RxAdu;          // Request
+    uint8_t *Tx_Adu = &s->Tx[s->TxLen];        // Response
+
+    Tx_Adu[0] = Rx_Adu[0]; // Transaction identifier
+    Tx_Adu[1] = Rx_Adu[1]; // Transaction identifier
+    Tx_Adu[2] = Rx_Adu[2]; // Protocol identifier
+    Tx_Adu[3] = Rx_Adu[3]; // Protocol identifier
+    Tx_Adu[4] = 0;                   // Following bytes
+    Tx_Adu[5] = 3;                   // Number of bytes to follow
+    Tx_Adu[6] = Rx_Adu[6]; // Station number
+    Tx_Adu[7] = _FunCode | 0x80;     // Function code
+    Tx_Adu[8] = _ExCode;             // Exception code
+
+    MB_FunStats[MB_Functions[_FunCode].Stat].Exceptions++;
+
+    s->TxLen += 9; // Queue for sending
 }
 
 /*********************************************************************
- * Function: Normal response
- * Input parameters: socket_id - socket id,_FunCode :FunCode
- * Return value: none
- * Description: Send response data frame when communication data frame has no exception and executed successfully.
+ * Function: Start a session for a new connection
+ * Input parameter: socketid - socket id.
+ * Return value: Session, NULL if all TCP_SESSION_NUM sessions are in use
+ * Description: A session already open on the socket id is reset.
+ */
+MB_Session *MB_Session_Open(uint8_t socketid)
+{
+    MB_Session *s = MB_Session_Get(socketid);
+    uint8_t i;
+
+    for (i = 0; (s == NULL) && (i < TCP_SESSION_NUM); i++)
+        if (!MB_Sessions[i].Used)
+            s = &MB_Sessions[i];
+    if (s == NULL)
+        return NULL;
+
+    s->Used = 1;
+    s->Socket = socketid;
+    s->RxLen = 0;
+    s->TxLen = 0;
+    s->TxNum = 0;
+    MB_GW_Drop(socketid);
+    return s;
+}
+
+/*********************************************************************
+ * Function: Find the session of a connection
+ * Input parameter: socketid - socket id.
+ * Return value: Session, NULL if the socket has none
+ * Description: None
+ */
+MB_Session *MB_Session_Get(uint8_t socketid)
+{
+    uint8_t i;
+
+    for (i = 0; i < TCP_SESSION_NUM; i++)
+        if (MB_Sessions[i].Used && (MB_Sessions[i].Socket == socketid))
+            return &MB_Sessions[i];
+    return NULL;
+}
+
+/*********************************************************************
+ * Function: End the session of a connection
+ * Input parameter: socketid - socket id.
+ * Return value: None
+ * Description: Queued responses and a partial request are dropped.
+ */
+void MB_Session_Close(uint8_t socketid)
+{
+    MB_Session *s = MB_Session_Get(socketid);
+
+    if (s != NULL)
+        s->Used = 0;
+    MB_GW_Drop(socketid);
+}
+
+/*********************************************************************
+ * Function: Send the queued responses
+ * Input parameter: s - Modbus session.
+ * Return value: None
+ * Description: All responses queued in the session go out together, WCHNET_SocketSend
+ *              is called again for what it did not take, as Data_Send does. What the
+ *              socket still holds back stays at the start of s->Tx, in front of the
+ *              next responses, and goes out with the next flush.
  */
-void MB_TCP_RSP(uint8_t socket_id, uint8_t _FunCode)
+void MB_TCP_Flush(MB_Session *s)
 {
-    P_Addr = ((MODBUSDataBuffer[8] << 8) | MODBUSDataBuffer[9]);     // Register address
-    P_RegNum = ((MODBUSDataBuffer[10] << 8) | MODBUSDataBuffer[11]); // Register number
+    uint32_t len, sent = 0;
+    uint8_t timeout = 50;
+
+    if (!s->Used)
+        return;
 
-    switch (_FunCode)
+    while ((sent < s->TxLen) && timeout--)
     {
-        case 01:                        // 0x01 Read Multiple Coils
-        case 02:                        // 0x02 Read Multiple Discrete Inputs
-            TCP_RSP_01_02(socket_id);
-        break;
-        case 03:                        // 0x03 Read Multiple Holding Registers
-        case 04:                        // 0x04 Read Multiple Input Registers
-            TCP_RSP_03_04(socket_id);
-            break;
-        case 05:                        // 0x05 Write Single Coil
-            TCP_RSP_05(socket_id);
-            break;
-        case 06:                        // 0x06 Write Single Holding Register
-            TCP_RSP_06(socket_id);
-            break;
-        case 15:                        // 0X0F Write Multiple Coils
-            TCP_RSP_0F(socket_id);
+        len = s->TxLen - sent;
+        WCHNET_SocketSend(s->Socket, &s->Tx[sent], &len); // Socket sends data.
+        sent += len;
+    }
+    if (sent < s->TxLen) // Send buffers full
+    {
+        memmove(s->Tx, &s->Tx[sent], s->TxLen - sent);
+        s->TxLen -= sent;
+        return;
+    }
+    if (s->TxNum)
+        MB_TxSegmentsSaved += s->TxNum - 1;
+    s->TxLen = 0;
+    s->TxNum = 0;
+}
+
+/*********************************************************************
+ * Function: Make room for one more response
+ * Input parameters: s - Modbus session, need - bytes of the response
+ * Return value: 1 if there is room in s->Tx, 0 if the connection was closed
+ * Description: The queued responses are sent if there is not. If the socket does not
+ *              take enough of them, a response left out would put every later one
+ *              out of step with its request: the connection is closed instead.
+ */
+uint8_t MB_TCP_Room(MB_Session *s, uint16_t need)
+{
+    if (TCP_TX_BUF_LEN - s->TxLen >= need)
+        return 1;
+    MB_TCP_Flush(s);
+    if (TCP_TX_BUF_LEN - s->TxLen >= need)
+        return 1;
+
+    WCHNET_SocketClose(s->Socket, TCP_CLOSE_NORMAL);
+    MB_Session_Close(s->Socket);
+    return 0;
+}
+
+/*********************************************************************
+ * Function: Analyze and execute one request
+ * Input parameter: s - Modbus session.
+ * Return value: None
+ * Description: s->RxAdu is a complete ADU, the response is queued in s->Tx, or
+ *              later by the gateway for a downstream unit id (ModbusGateway.c).
+ *              The request and its run time are counted in MB_FunStats.
+ */
+void MB_Parse_ADU(MB_Session *s)
+{
+    const uint8_t *Rx_Adu = s->RxAdu;
+    const MB_Function *f = &MB_Functions[Rx_Adu[7]];
+    MB_FunStat *st = &MB_FunStats[f->Stat];
+    uint16_t len = Rx_Adu[5] | Rx_Adu[4] << 8; // Station number + PDU
+    uint32_t t0 = MB_CYCLES(), t;
+
+    st->Requests++;
+    if (!MB_GW_Local(Rx_Adu[6])) // Slave ID of a downstream device
+        MB_GW_Request(s);
+    else if (f->Handler == NULL) // Function code
+    {
+        printf("Function code error response\n");
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x01); // Function code error response
+    }
+    else if ((len < f->MinLen) || (len > f->MaxLen))
+        TCP_Exception_RSP(s, Rx_Adu[7], 0x03); // Request too short or too long for the function code
+    else
+    {
+        s->Addr = ((Rx_Adu[8] << 8) | Rx_Adu[9]);     // Register address
+        s->RegNum = (len < 6) ? 0 : ((Rx_Adu[10] << 8) | Rx_Adu[11]); // Register number, FC43 has none
+        f->Handler(s); // Normal feedback
+    }
+
+    t = MB_CYCLES() - t0;
+    if ((int32_t) t < 0) // The counter reloaded meanwhile
+        t += MB_CYCLES_RELOAD;
+    st->Cycles += t;
+}
+
+/*********************************************************************
+ * Function: Analyze and execute the received data
+ * Input parameters: s - Modbus session, buf - received data, P_RxCount - bytes in buf
+ * Return value: Bytes used, the rest is the start of an ADU still being received
+ * Description: Walks the buffer one MBAP frame at a time, so several pipelined
+ *              requests in one segment are all served. Their responses are queued
+ *              in the session, the caller sends them with MB_TCP_Flush when it is
+ *              done with the socket. The caller keeps the unused bytes and puts the
+ *              next received data after them.
+ */
+uint32_t MB_Parse_Data(MB_Session *s, const uint8_t *buf, uint32_t P_RxCount)
+{
+    uint32_t pos = 0, adu;
+    uint16_t len;
+
+    if (!s->Used) // Closed by MB_TCP_Room
+        return P_RxCount;
+
+    while (P_RxCount - pos >= 6) // MBAP length field received
+    {
+        s->RxAdu = &buf[pos];
+        adu = 6 + (s->RxAdu[5] | s->RxAdu[4] << 8);
+
+        if (!MB_TCP_Room(s, TCP_ADU_MAX)) // Connection closed, the rest is dropped
+            return P_RxCount;
+
+        if ((adu < 8) || (adu > TCP_ADU_MAX)) // Not a Modbus ADU, the frame boundary is lost
+        {
+            uint8_t hdr[8] = { 0 }; // Station number and function code may not be received
+
+            memcpy(hdr, s->RxAdu, (P_RxCount - pos < 8) ? P_RxCount - pos : 8);
+            s->RxAdu = hdr;
+            printf("Quantity error response\n");
+            TCP_Exception_RSP(s, hdr[7], 0x04); // Quantity error response
+            s->TxNum++;
+            pos = P_RxCount; // Drop the rest of the data
             break;
-        case 16:                        // 0x10 Write Multiple Holding Registers
-            TCP_RSP_10(socket_id);
+        }
+        if (P_RxCount - pos < adu) // Partial ADU, wait for the rest
             break;
+
+        len = s->TxLen;
+        MB_Parse_ADU(s);
+        if (s->TxLen != len) // Not waiting for a downstream device
+            s->TxNum++;
+        pos += adu;
     }
+    return pos;
 }
 
 /*********************************************************************
- * Function: Analyze and execute the received data
- * Input parameter: _Socketid - socket id.
+ * Function: Receive and execute Modbus requests
+ * Input parameter: socketid - socket id.
  * Return value: None
- * Description: None
+ * Description: Requests are parsed in place in the socket receive buffer
+ *              (WCHNET_SocketRecvLen address), nothing is copied out. Only an ADU
+ *              split over two receives is put together in the session buffer, so
+ *              the socket buffer is always emptied and restarts at its beginning.
+ *              All responses are sent together at the end.
  */
-void MB_Parse_Data(uint8_t _Socketid, uint32_t  P_RxCount) {
+void MB_TCP_Receive(uint8_t socketid)
+{
+    MB_Session *s = MB_Session_Get(socketid);
+    const uint8_t *buf;
+    uint32_t addr, len, pos = 0, n, used;
+
+    len = WCHNET_SocketRecvLen(socketid, &addr);
+    buf = (const uint8_t *) addr;
 
-	//printf("(P_RxCount - 6) = %d \n", (P_RxCount - 6));
-    //printf("(MODBUSDataBuffer[5] | MODBUSDataBuffer[4] << 8) = %d \n", (MODBUSDataBuffer[5] | MODBUSDataBuffer[4] << 8));
+    if (s == NULL)
+    {
+        WCHNET_SocketRecv(socketid, NULL, &len); // No session, discard
+        return;
+    }
 
-    if ((P_RxCount - 6) == (MODBUSDataBuffer[5] | MODBUSDataBuffer[4] << 8)) // Validation number
+    if (s->RxLen) // Finish the ADU started in the previous receive
     {
-        if (MODBUSDataBuffer[6] < TCP_ALLSLAVEADDR) // Slave ID
+        n = TCP_ADU_MAX - s->RxLen;
+        if (n > len)
+            n = len;
+        memcpy(s->Rx + s->RxLen, buf, n);
+        used = MB_Parse_Data(s, s->Rx, s->RxLen + n);
+        if (used == 0) // Still not complete, all of buf is in s->Rx
+        {
+            s->RxLen += n;
+            pos = n;
+        }
+        else
         {
-            if ((MODBUSDataBuffer[7] == 01) || (MODBUSDataBuffer[7] == 02) || (MODBUSDataBuffer[7] == 03) || (MODBUSDataBuffer[7] == 04) ||
-			    (MODBUSDataBuffer[7] == 05) || (MODBUSDataBuffer[7] == 06) || (MODBUSDataBuffer[7] == 15) || (MODBUSDataBuffer[7] == 16)) // Function code
-            {
-                MB_TCP_RSP(_Socketid, MODBUSDataBuffer[7]); // Normal feedback
-            } else {
-                printf("Function code error response\n");
-                TCP_Exception_RSP(_Socketid, MODBUSDataBuffer[7], 0x01); // Function code error response
-            }
-        } else {
-            printf("Station number error response\n");
-            TCP_Exception_RSP(_Socketid, MODBUSDataBuffer[7], 0x03); // ID station number error response
+            pos = used - s->RxLen;
+            s->RxLen = 0;
         }
-    } else {
-        printf("Quantity error response\n");
-        TCP_Exception_RSP(_Socketid, MODBUSDataBuffer[7], 0x04); // Quantity error response
     }
-    P_RxCount = 0;
+
+    if (s->RxLen == 0)
+    {
+        pos += MB_Parse_Data(s, buf + pos, len - pos);
+        if (pos < len) // Start of the next ADU
+        {
+            s->RxLen = len - pos;
+            memcpy(s->Rx, buf + pos, s->RxLen);
+            pos = len;
+        }
+    }
+
+    WCHNET_SocketRecv(socketid, NULL, &pos); // Free what was used
+    MB_TCP_Flush(s);
 }
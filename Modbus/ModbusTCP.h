@@ -13,17 +13,57 @@
 #define __MODBUSTCP_H__
 
 /* Include header file ----------------------------------------------------------------*/
-
-/* Type definition ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "net_config.h"
 
 /* Macro definition --------------------------------------------------------------------*/
 #define TCP_ALLSLAVEADDR 255
-#define TCP_MAX 100
+#define TCP_READ_BITS_MAX 2000     // Max. quantity of coils/inputs in one read (FC01/FC02)
+#define TCP_WRITE_BITS_MAX 1968    // Max. quantity of coils in one write (FC15)
+#define TCP_READ_REGS_MAX 125      // Max. quantity of registers in one read (FC03/FC04)
+#define TCP_WRITE_REGS_MAX 123     // Max. quantity of registers in one write (FC16)
+#define TCP_RW_WRITE_REGS_MAX 121  // Max. quantity of registers written by FC23
+#define TCP_ADU_MAX 260            // Max. Modbus TCP ADU: MBAP 7 + PDU 253
+#define TCP_CHANGES_MAX 27         // Max. number of changes in one FC65 response: (253 - 7) / 9
+
+#define TCP_SESSION_NUM WCHNET_NUM_TCP   // Modbus connections served at the same time
+#define TCP_TX_BUF_LEN WCHNET_TCP_MSS    // Session transmit buffer, responses sent together
+#define TCP_FUN_STAT_NUM 13        // Function codes with statistics, slot 0 counts all unsupported ones
+
+/* Type definition ------------------------------------------------------------------*/
+typedef struct
+{
+    uint8_t Used;                     // Session in use
+    uint8_t Socket;                   // Socket id of the connection
+    uint16_t RxLen;                   // Bytes of a partial ADU in Rx
+    uint16_t TxLen;                   // Bytes queued in Tx
+    uint16_t TxNum;                   // Responses queued in Tx
+    const uint8_t *RxAdu;             // Request being served
+    uint16_t Addr, RegNum;            // Its register address and register count
+    uint8_t Rx[TCP_ADU_MAX];          // An ADU split over two receives
+    uint8_t Tx[TCP_TX_BUF_LEN];       // Transmit buffer
+} MB_Session;
+
+typedef struct
+{
+    uint8_t FunCode;                  // Function code of the slot, 0 for the unsupported codes
+    uint32_t Requests;                // Requests received
+    uint32_t Exceptions;              // Exception responses sent, framing errors included
+    uint32_t Cycles;                  // Time spent executing them in HCLK cycles, wraps around
+} MB_FunStat;
 
 /* Extended variables ------------------------------------------------------------------*/
+extern uint32_t MB_TxSegmentsSaved; // Responses sent in a segment together with others
+extern MB_FunStat MB_FunStats[TCP_FUN_STAT_NUM]; // Per function code statistics
 
 /* Function declaration ------------------------------------------------------------------*/
-void MB_Parse_Data(uint8_t _Socketid, uint32_t  P_RxCount); // mosbus TCP parsing data
+MB_Session *MB_Session_Open(uint8_t socketid);  // New connection, NULL if no session is free
+MB_Session *MB_Session_Get(uint8_t socketid);   // Session of a connection, NULL if none
+void MB_Session_Close(uint8_t socketid);        // Connection closed
+void MB_TCP_Receive(uint8_t socketid); // Read the socket, execute the requests, send the responses
+uint32_t MB_Parse_Data(MB_Session *s, const uint8_t *buf, uint32_t P_RxCount); // mosbus TCP parsing data, returns bytes used
+void MB_TCP_Flush(MB_Session *s); // Send the responses queued by MB_Parse_Data
+uint8_t MB_TCP_Room(MB_Session *s, uint16_t need); // Room for a response, 0: connection closed
 
 #endif
 
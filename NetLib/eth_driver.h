@@ -151,6 +151,7 @@
 extern ETH_DMADESCTypeDef *DMATxDescToSet;
 extern ETH_DMADESCTypeDef *DMARxDescToGet;
 extern SOCK_INF SocketInf[ ];
+extern volatile uint32_t LocalTime;
 
 void ETH_PHYLink( void );
 void WCHNET_ETHIsr( void );
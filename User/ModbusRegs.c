@@ -0,0 +1,231 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : ModbusRegs.c
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Modbus register map of the application. The regions point
+ *                      straight at the variables they publish, nothing is copied.
+*********************************************************************************/
+
+/*
+    Coils              0 ..  799   coil[], read / write
+    Discrete inputs    0 ..   31   dinput[], bit 0 is the PB3 button (1 = pressed)
+    Holding registers  0 ..   99   mreg[], read / write, changes are journaled
+                    1000 .. 1011   PARAMETERSDataBuffer[], read only
+                    1100 .. 1101   uptime in ms (LocalTime), high word first, read only
+    Input registers    0 ..   63   ireg bank, 0 .. 11 are a snapshot of PARAMETERSDataBuffer[],
+                                   changes are journaled
+                    1100 .. 1101   uptime, as above
+                    1200 .. 1201   Modbus TCP segments saved by sending responses together
+                    1400 .. 1407   Modbus gateway: forwarded, cache hits, joined, timeouts (32-bit each)
+                    1500 .. 1509   Modbus RTU master: requests, responses, timeouts, errors,
+                                   dropped (32-bit each)
+                    1600 .. 1703   Modbus function code statistics, 8 registers per function code:
+                                   code, 0, requests, exceptions, HCLK cycles (32-bit, high word first)
+                                   1600 counts the unsupported codes, then FC 1..6, 15, 16, 22, 23, 43, 65
+
+    Journaled registers are read with FC65 (Read Changes) as well, see ModbusTCP.c.
+
+    Unit ids 1 and 255 are this device. Unit ids RTU_UNIT_FIRST .. RTU_UNIT_LAST are the
+    devices on the RS-485 bus (USART2), their requests are bridged to Modbus RTU. None are
+    by default. The others are served locally as well (MB_GW_UNROUTED_LOCAL).
+
+    Keep each table sorted by start address. Bit arrays are 4 byte aligned and a
+    whole number of 32-bit words long, they are accessed a word at a time.
+ */
+
+#include <stddef.h>
+
+#include "eth_driver.h"
+#include "main.h"
+#include "ModbusMap.h"
+#include "ModbusGateway.h"
+#include "ModbusRTU.h"
+#include "ModbusRegs.h"
+#include "ModbusTCP.h"
+
+#if (COIL_NUM % 32) || (DINPUT_NUM % 32)
+    #error "COIL_NUM/DINPUT_NUM Error,Please Configure them as a multiple of 32"
+#endif
+
+// A bridged request is answered or dropped by the RTU master before the gateway gives up on it
+#if (MB_RTU_QUEUE_MS + MB_RTU_TIMEOUT_MS + 50 > MB_GW_TIMEOUT_MS)
+    #error "MB_GW_TIMEOUT_MS Error,Please Configure it above MB_RTU_QUEUE_MS + MB_RTU_TIMEOUT_MS + 50"
+#endif
+
+uint8_t coil[COIL_NUM / 8] __attribute__((aligned(4))); // Coils, 8 per byte, read 32 bits at a time
+uint16_t mreg[MREG_NUM]; // Register
+uint8_t dinput[DINPUT_NUM / 8] __attribute__((aligned(4))); // Discrete inputs, 8 per byte
+static uint16_t IregBuf[2][IREG_NUM]; // Input registers, published and refreshed copy
+MB_Bank ireg = { 0, { IregBuf[0], IregBuf[1] }, sizeof(IregBuf[0]) };
+
+/*********************************************************************
+ * @fn      Read_U32
+ *
+ * @brief   Part of a 32-bit value as two registers, high word first.
+ *
+ * @param   t - value, offset - first register, count - number of registers, dst - output
+ *
+ * @return  0
+ */
+static uint8_t Read_U32(uint32_t t, uint16_t offset, uint16_t count, uint8_t *dst)
+{
+    uint16_t v[2] = { t >> 16, t };
+
+    while (count--)
+    {
+        *dst++ = v[offset];         // Low byte
+        *dst++ = v[offset++] >> 8;  // High byte
+    }
+    return 0;
+}
+
+/*********************************************************************
+ * @fn      Uptime_Read
+ *
+ * @brief   Modbus read callback, LocalTime in ms.
+ *
+ * @return  0
+ */
+static uint8_t Uptime_Read(uint16_t offset, uint16_t count, uint8_t *dst)
+{
+    return Read_U32(LocalTime, offset, count, dst);
+}
+
+/*********************************************************************
+ * @fn      TxSaved_Read
+ *
+ * @brief   Modbus read callback, MB_TxSegmentsSaved.
+ *
+ * @return  0
+ */
+static uint8_t TxSaved_Read(uint16_t offset, uint16_t count, uint8_t *dst)
+{
+    return Read_U32(MB_TxSegmentsSaved, offset, count, dst);
+}
+
+/*********************************************************************
+ * @fn      FunStats_Read
+ *
+ * @brief   Modbus read callback, MB_FunStats.
+ *
+ * @return  0
+ */
+static uint8_t FunStats_Read(uint16_t offset, uint16_t count, uint8_t *dst)
+{
+    const MB_FunStat *f;
+    uint16_t v[8];
+
+    for (; count; count--, offset++)
+    {
+        f = &MB_FunStats[offset / 8];
+        v[0] = f->FunCode;
+        v[1] = 0;
+        v[2] = f->Requests >> 16;
+        v[3] = f->Requests;
+        v[4] = f->Exceptions >> 16;
+        v[5] = f->Exceptions;
+        v[6] = f->Cycles >> 16;
+        v[7] = f->Cycles;
+
+        *dst++ = v[offset % 8];         // Low byte
+        *dst++ = v[offset % 8] >> 8;    // High byte
+    }
+    return 0;
+}
+
+/*********************************************************************
+ * @fn      GwStats_Read
+ *
+ * @brief   Modbus read callback, MB_GW_Stats.
+ *
+ * @return  0
+ */
+static uint8_t GwStats_Read(uint16_t offset, uint16_t count, uint8_t *dst)
+{
+    const uint32_t v[4] = { MB_GW_Stats.Forwarded, MB_GW_Stats.CacheHits, MB_GW_Stats.Joined, MB_GW_Stats.Timeouts };
+
+    for (; count; count--, offset++, dst += 2)
+        Read_U32(v[offset / 2], offset % 2, 1, dst);
+    return 0;
+}
+
+/*********************************************************************
+ * @fn      RtuStats_Read
+ *
+ * @brief   Modbus read callback, MB_RTU_Stats.
+ *
+ * @return  0
+ */
+static uint8_t RtuStats_Read(uint16_t offset, uint16_t count, uint8_t *dst)
+{
+    const uint32_t v[5] = { MB_RTU_Stats.Requests, MB_RTU_Stats.Responses, MB_RTU_Stats.Timeouts,
+                            MB_RTU_Stats.Errors, MB_RTU_Stats.Dropped };
+
+    for (; count; count--, offset++, dst += 2)
+        Read_U32(v[offset / 2], offset % 2, 1, dst);
+    return 0;
+}
+
+#if RTU_UNIT_LAST
+#if (RTU_UNIT_FIRST < 2) || (RTU_UNIT_FIRST > RTU_UNIT_LAST) || (RTU_UNIT_LAST > 247)
+#error "RTU_UNIT_FIRST .. RTU_UNIT_LAST must be within the device unit ids 2 .. 247"
+#endif
+
+/*********************************************************************
+ * @fn      Rtu_Submit
+ *
+ * @brief   Modbus gateway transport, the RS-485 bus. Each Modbus TCP client is
+ *          one flow of the RTU master, so the clients take turns on the bus.
+ *
+ * @return  0 or exception code
+ */
+static uint8_t Rtu_Submit(uint8_t client, uint8_t unit, const uint8_t *pdu, uint16_t len, uint16_t tag)
+{
+    return MB_RTU_Submit(MB_RTU_PRIO_NORMAL, client, unit, pdu, len, MB_GW_Done, tag);
+}
+#endif
+
+static const MB_Region CoilRegions[] = {
+    /* Start  Count           Flags          Data                   Read         Write */
+    {     0,  COIL_NUM,       0,             coil,                  NULL,        NULL },
+};
+
+static const MB_Region DiscreteRegions[] = {
+    {     0,  DINPUT_NUM,     MB_REGION_RO,  dinput,                NULL,        NULL },
+};
+
+static const MB_Region HoldingRegions[] = {
+    {     0,  MREG_NUM,       MB_REGION_JOURNAL, mreg,              NULL,        NULL },
+    {  1000,  NOofPARAMETERS, MB_REGION_RO,  PARAMETERSDataBuffer,  NULL,        NULL },
+    {  1100,  2,              0,             NULL,                  Uptime_Read, NULL },
+};
+
+static const MB_Region InputRegions[] = {
+    {     0,  IREG_NUM,       MB_REGION_BANK, &ireg,                NULL,        NULL },
+    {  1100,  2,              0,             NULL,                  Uptime_Read, NULL },
+    {  1200,  2,              0,             NULL,                  TxSaved_Read, NULL },
+    {  1400,  8,              0,             NULL,                  GwStats_Read, NULL },
+    {  1500,  10,             0,             NULL,                  RtuStats_Read, NULL },
+    {  1600,  TCP_FUN_STAT_NUM * 8, 0,       NULL,                  FunStats_Read, NULL },
+};
+
+#define REGION_NUM(t)   (sizeof(t) / sizeof((t)[0]))
+
+const MB_Table MB_Map[MB_SPACE_NUM] = {
+    [MB_SPACE_COILS]    = { CoilRegions,     REGION_NUM(CoilRegions) },
+    [MB_SPACE_DISCRETE] = { DiscreteRegions, REGION_NUM(DiscreteRegions) },
+    [MB_SPACE_HOLDING]  = { HoldingRegions,  REGION_NUM(HoldingRegions) },
+    [MB_SPACE_INPUT]    = { InputRegions,    REGION_NUM(InputRegions) },
+};
+
+#if RTU_UNIT_LAST
+static const MB_GW_Route GatewayRoutes[] = {
+    /* First           Last           Transport */
+    { RTU_UNIT_FIRST,  RTU_UNIT_LAST, Rtu_Submit },
+};
+
+const MB_GW_Table MB_GW_Routes = { GatewayRoutes, REGION_NUM(GatewayRoutes) };
+#else
+const MB_GW_Table MB_GW_Routes = { NULL, 0 }; // No device on the bus configured, all unit ids are local
+#endif
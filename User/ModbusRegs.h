@@ -0,0 +1,38 @@
+/********************************** (C) COPYRIGHT *******************************
+ * File Name          : ModbusRegs.h
+ * Author             : Nedelcu Bogdan Sebastian
+ * Version            : V1.0.0
+ * Date               : 17-October-2026
+ * Description        : Modbus register banks of the application.
+*********************************************************************************/
+#ifndef __MODBUSREGS_H__
+#define __MODBUSREGS_H__
+
+#include <stdint.h>
+#include "ModbusMap.h"
+
+#define COIL_NUM    800   // Coils, multiple of 32
+#define MREG_NUM    100   // Holding registers
+#define DINPUT_NUM  32    // Discrete inputs, multiple of 32
+#define IREG_NUM    64    // Input registers
+
+/*
+ * Unit ids bridged to the devices on the RS-485 bus, RTU_UNIT_LAST 0: none, every unit id
+ * is this device. get_ModbusTCP.py talks to this device as units 2 and 8, keep a range
+ * set here clear of the unit ids the clients use for it.
+ */
+#define RTU_UNIT_FIRST  0
+#define RTU_UNIT_LAST   0
+
+extern uint8_t coil[COIL_NUM / 8];      // Coils, read / write by the clients
+extern uint16_t mreg[MREG_NUM];         // Holding registers, read / write by the clients
+
+/*
+ * Read only banks, written only by the acquisition code, Modbus writes never land here.
+ * Input registers are double buffered: refresh them between MB_Bank_Begin(&ireg) and
+ * MB_Bank_Publish(&ireg), clients then never see a value that is half old, half new.
+ */
+extern uint8_t dinput[DINPUT_NUM / 8];  // Discrete inputs, 8 per byte
+extern MB_Bank ireg;                    // Input registers, two uint16_t[IREG_NUM]
+
+#endif
@@ -11,6 +11,7 @@
 *******************************************************************************/
 #include "eth_driver.h"
 #include "ch32v30x_it.h"
+#include "ModbusRTU.h"
 
 extern volatile uint32_t TimingDelay;
 extern volatile uint32_t WEBSOCKETTimingDelay;
@@ -122,5 +123,6 @@ void SysTick_Handler(void)
 		SysTick->SR = 0; //clear State flag
 		if (TimingDelay != 0x00) TimingDelay--;
 		if (WEBSOCKETTimingDelay != 0x00) WEBSOCKETTimingDelay--;
+		MB_RTU_TimeIsr(1); // Modbus RTU frame timing
 	}
 }
@@ -81,9 +81,18 @@
 #include "HTTPS.h"
 #include "CRC16.h"
 #include "ModbusTCP.h"
+#include "ModbusMap.h"
+#include "ModbusDevId.h"
+#include "ModbusGateway.h"
+#include "ModbusRTU.h"
+#include "ModbusRegs.h"
 #include "websocket.h"
 #include "wshandshake.h"
 
+#if (NOofPARAMETERS > IREG_NUM)
+    #error "IREG_NUM Error,Input registers must hold all PARAMETERSDataBuffer values"
+#endif
+
 #define EXIT_SUCCESS 0
 #define EXIT_FAILURE 1
 
@@ -96,9 +105,6 @@
 volatile uint32_t TimingDelay;
 volatile uint32_t WEBSOCKETTimingDelay;
 
-uint8_t coil[100]; // Coil
-uint16_t mreg[100]; // Register
-
 #define RED_LED_ON        GPIOA->BSHR = GPIO_Pin_15
 #define RED_LED_OFF       GPIOA->BCR = GPIO_Pin_15
 #define RED_LED_TOGGLE    GPIOA->OUTDR ^= GPIO_Pin_15
@@ -108,6 +114,8 @@ uint16_t mreg[100]; // Register
 #define MODBUS_SERVER_PORT          502
 #define WEBSOCKET_SERVER_PORT       8088
 
+#define BUTTON_RTU_FLOW             0xFF  /* RS-485 requester of the PB3 button, the Modbus TCP sockets are the others */
+
 u8 MACAddr[6]; //MAC address
 u8 IPAddr[4]; //IP address
 u8 GWIPAddr[4]; //Gateway IP address
@@ -122,7 +130,6 @@ u8 SocketId, SocketIdForListen;
 #define BUF_LEN  512
 
 u8 HTTPDataBuffer[RECE_BUF_LEN];
-u8 MODBUSDataBuffer[RECE_BUF_LEN];
 //u8 WEBSOCKETDataBuffer[RECE_BUF_LEN];
 
 struct fds {
@@ -142,6 +149,7 @@ u8 SocketRecvBuf[WCHNET_MAX_SOCKET_NUM][RECE_BUF_LEN]; //socket receive buffer
 u16 counter = 0;
 
 u16 PARAMETERSDataBuffer[NOofPARAMETERS];
+u32 PARAMETERSGeneration; // Incremented when PARAMETERSDataBuffer changes, the /json page is rebuilt then
 
 const char *PARAMETERSNameBuffer[] = {
 	"\"Toil_var\": %d,",
@@ -556,22 +564,21 @@ void WCHNET_HandleSockInt(u8 socketid, u8 intstat)
 			printf(" === HTTP socket received data length:%d\r\n",len);
 		    printf(HTTPDataBuffer);
 #endif
-            Web_Server();
-            // After the request is processed, the current socket connection is closed, and a new connection
-            // will be established when the browser sends the next request
-            WCHNET_SocketClose(socket, TCP_CLOSE_NORMAL);
-            // Clear HTTP data buffer
-            memset(HTTPDataBuffer, 0, sizeof(HTTPDataBuffer));
+            // The connection stays open for the next request (keep-alive), unless the client
+            // asked to close it, it is not a persistent one or it served HTTP_KEEPALIVE_MAX requests
+            if (!Web_Server(len))
+            {
+                HTTP_Close(socket);
+                WCHNET_SocketClose(socket, TCP_CLOSE_NORMAL);
+            }
             BLUE_LED_TOGGLE;
         }
         if (SocketInf[socketid].SourPort == MODBUS_SERVER_PORT) {      // Receive MODBUS data
             socket = socketid;
-            WCHNET_SocketRecv(socketid, MODBUSDataBuffer, &len);
 #ifdef DEBUG_DATA_MODBUS
             printf(" === MODBUS socket received data length:%d\r\n",len);
 #endif
-            MB_Parse_Data(socketid, len);
-            memset(MODBUSDataBuffer, 0, sizeof(HTTPDataBuffer));
+            MB_TCP_Receive(socketid);                                   // All responses of this pass in one segment
             RED_LED_TOGGLE;
         }
         if (SocketInf[socketid].SourPort == WEBSOCKET_SERVER_PORT) {   // Receive WEBSOCKET data
@@ -608,6 +615,10 @@ void WCHNET_HandleSockInt(u8 socketid, u8 intstat)
     if (intstat & SINT_STAT_CONNECT)                                // Connect successfully
     {
         WCHNET_ModifyRecvBuf(socketid, (u32)SocketRecvBuf[socketid], RECE_BUF_LEN);
+        if ((SocketInf[socketid].SourPort == MODBUS_SERVER_PORT) && (MB_Session_Open(socketid) == NULL))
+            WCHNET_SocketClose(socketid, TCP_CLOSE_NORMAL);         // All Modbus sessions in use
+        if (SocketInf[socketid].SourPort == HTTP_SERVER_PORT)
+            HTTP_Open(socketid);
 #ifdef DEBUG_DATA_HTTP
         if (SocketInf[socketid].SourPort == HTTP_SERVER_PORT)
         	printf(" === HTTP TCP socket %d connected\n", socketid);
@@ -623,6 +634,8 @@ void WCHNET_HandleSockInt(u8 socketid, u8 intstat)
     }
     if (intstat & SINT_STAT_DISCONNECT)                             // Disconnect
     {
+        MB_Session_Close(socketid);
+        HTTP_Close(socketid);
 #ifdef DEBUG_DATA_HTTP
         if (SocketInf[socketid].SourPort == HTTP_SERVER_PORT)
         	printf(" === HTTP TCP socket %d disconnected\n", socketid);
@@ -639,6 +652,8 @@ void WCHNET_HandleSockInt(u8 socketid, u8 intstat)
 
     if (intstat & SINT_STAT_TIM_OUT)                                // Timeout disconnect
     {
+        MB_Session_Close(socketid);
+        HTTP_Close(socketid);
     	// When python Websocket client is forced close it does not send any WS_CLOSING_FRAME
     	// and to correctly close the socket for the lost client we manage the timeout
     	// Keep in mind that the Websocket is a stay alive type, is not closed
@@ -822,6 +837,8 @@ int main(void)
         printf("%x ", MACAddr[i]);
     printf("\n");
 
+    MB_DevId_Init(DBGMCU_GetCHIPID(), MACAddr);                                 // Modbus FC43 device identification
+
 
     TIM2_Init();
 
@@ -835,28 +852,45 @@ int main(void)
     if (i == WCHNET_ERR_SUCCESS)
         printf("WCHNET_LibInit Success\r\n");
 
+    i = MB_Map_Check();
+    if (i)
+        printf("Modbus register map error, space %d\r\n", i - 1);
+
+    MB_RTU_Init();                                                              // Modbus RTU master on USART2 (RS-485)
+
+    i = HTTP_Route_Init();
+    if (i)
+        printf("HTTP route table error, route %d\r\n", i - 1);
+
     WCHNET_CreateHTTPSocket();
     WCHNET_CreateMODBUSSocket();
     WCHNET_CreateWEBSOCKETSocket();
 
     while(1)
     {
-    	if (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_3) == 0)
+    	// Queued for the RS-485 bus between the Modbus RTU frames, again at most every 2 s while held
+    	if ((GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_3) == 0) && (TimingDelay == 0x00))
     	{
-    		USART2_Print("/SENDCHID\\");
-    		//__disable_irq();
+    		MB_RTU_Submit_Raw(MB_RTU_PRIO_NORMAL, BUTTON_RTU_FLOW, (const uint8_t *) "/SENDCHID\\", 10);
     		TimingDelay = 2000;
-    	    while (TimingDelay != 0x00);
-            //__enable_irq();
     	}
 
         /*Ethernet library main task function,
          * which needs to be called cyclically*/
         WCHNET_MainTask();
+        /*Modbus gateway transactions without a response*/
+        MB_GW_Poll();
+        /*Modbus RTU master, never waits for the bus*/
+        MB_RTU_Poll();
+        /*HTTP bodies being sent from flash, keep-alive connections left idle*/
+        HTTP_Poll();
         /*Query the Ethernet global interrupt,
          * if there is an interrupt, call the global interrupt handler*/
         if(WCHNET_QueryGlobalInt())
         {
+        	u16 last[NOofPARAMETERS];
+
+        	memcpy(last, PARAMETERSDataBuffer, sizeof(last));
         	PARAMETERSDataBuffer[0] = 123;
         	PARAMETERSDataBuffer[1] = 456;
         	PARAMETERSDataBuffer[2] = 789;
@@ -869,6 +903,14 @@ int main(void)
         	PARAMETERSDataBuffer[9] = 12345;
         	PARAMETERSDataBuffer[10] = 6789;
         	PARAMETERSDataBuffer[11] = counter++;
+        	if (memcmp(last, PARAMETERSDataBuffer, sizeof(last)) != 0)
+        	    PARAMETERSGeneration++;
+
+        	// Read only Modbus banks, one copy per refresh, client writes go to mreg[]/coil[]
+        	memcpy(MB_Bank_Begin(&ireg), PARAMETERSDataBuffer, sizeof(PARAMETERSDataBuffer));
+        	MB_Bank_Publish(&ireg);
+        	MB_Bank_Journal(&ireg, MB_SPACE_INPUT, 0, NOofPARAMETERS);
+        	dinput[0] = (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_3) == 0); // PB3 pressed
 
         	WCHNET_HandleGlobalInt();
         }
@@ -11,6 +11,7 @@
 #define NOofPARAMETERS   12
 
 extern u16 PARAMETERSDataBuffer[NOofPARAMETERS];
+extern u32 PARAMETERSGeneration; // Incremented when PARAMETERSDataBuffer changes
 
 extern const char *PARAMETERSNameBuffer[];
 
@@ -0,0 +1,178 @@
+'''
+Modbus TCP throughput and latency benchmark, pymodbus client.
+
+Same request mix syntax and report as Host/bench/mb_bench.c, so numbers taken
+with either client can be compared:
+
+    python bench_ModbusTCP.py 192.168.1.10
+    python bench_ModbusTCP.py 127.0.0.1 --port 10502 --rate 200 --duration 30
+    python bench_ModbusTCP.py 192.168.1.10 --mix 1:1:64 --rate 100
+
+Mix syntax: fc:weight[:quantity],... Supported function codes: 1, 3, 5, 6, 15, 16.
+With --rate the requests are sent on a fixed schedule and latency is taken from
+the scheduled send time, so a slow server is not hidden by the client waiting on it.
+
+Bytes on the wire are the Modbus ADU bytes (MBAP + PDU) plus an estimate of the
+Ethernet/IP/TCP framing, one segment per request and per reply.
+
+pip install pymodbus (2.x, same as get_ModbusTCP.py)
+'''
+
+import time
+import random
+import argparse
+
+from pymodbus.client.sync import ModbusTcpClient
+
+FRAME_OVERHEAD = 54    # Ethernet 14 + IPv4 20 + TCP 20
+FRAME_MIN = 60         # Ethernet minimum frame without FCS
+
+DEFAULT_QTY = {1: 64, 3: 40, 5: 1, 6: 1, 15: 16, 16: 10}
+DEFAULT_MIX = '1:30:64,3:30:40,5:10,6:10,15:10:16,16:10:10'
+
+
+def parse_mix(text):
+    mix = []
+    for item in text.split(','):
+        parts = [int(p) for p in item.split(':')]
+        fc, weight = parts[0], parts[1]
+        if fc not in DEFAULT_QTY:
+            raise ValueError('unsupported function code %d' % fc)
+        qty = parts[2] if len(parts) > 2 else DEFAULT_QTY[fc]
+        if fc in (5, 6):
+            qty = 1
+        mix.append({'fc': fc, 'weight': weight, 'qty': qty, 'lat': [], 'exc': 0})
+    return mix
+
+
+# Request and normal response ADU sizes, MBAP (7) + PDU
+def adu_sizes(fc, qty):
+    if fc == 1:
+        return 12, 9 + (qty + 7) // 8
+    if fc == 3:
+        return 12, 9 + 2 * qty
+    if fc == 15:
+        return 13 + (qty + 7) // 8, 12
+    if fc == 16:
+        return 13 + 2 * qty, 12
+    return 12, 12
+
+
+def wire(adu):
+    return max(adu + FRAME_OVERHEAD, FRAME_MIN)
+
+
+def transact(client, entry, addr, unit, seq):
+    fc, qty = entry['fc'], entry['qty']
+    if fc == 1:
+        return client.read_coils(addr, qty, unit=unit)
+    if fc == 3:
+        return client.read_holding_registers(addr, qty, unit=unit)
+    if fc == 5:
+        return client.write_coil(addr, bool(seq & 1), unit=unit)
+    if fc == 6:
+        return client.write_register(addr, seq & 0xFFFF, unit=unit)
+    if fc == 15:
+        return client.write_coils(addr, [random.random() < 0.5 for i in range(qty)], unit=unit)
+    return client.write_registers(addr, [random.randint(0, 0xFFFF) for i in range(qty)], unit=unit)
+
+
+def pct(values, p):
+    if not values:
+        return 0.0
+    return values[int(p * (len(values) - 1) + 0.5)] * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Modbus TCP benchmark')
+    parser.add_argument('host', nargs='?', default='192.168.1.10')
+    parser.add_argument('--port', type=int, default=502)
+    parser.add_argument('--unit', type=int, default=1)
+    parser.add_argument('--mix', default=DEFAULT_MIX)
+    parser.add_argument('--addr', type=int, default=0, help='start address')
+    parser.add_argument('--span', type=int, default=0, help='randomize start address over [addr, addr+span)')
+    parser.add_argument('--rate', type=float, default=0, help='requests/s on a fixed schedule, 0 = back to back')
+    parser.add_argument('--duration', type=float, default=10)
+    parser.add_argument('--requests', type=int, default=0, help='stop after this many requests')
+    parser.add_argument('--seed', type=int, default=1)
+    args = parser.parse_args()
+
+    random.seed(args.seed)
+    mix = parse_mix(args.mix)
+    weights = [m['weight'] for m in mix]
+
+    client = ModbusTcpClient(host=args.host, port=args.port)
+    if not client.connect():
+        print('Cannot connect to %s:%d' % (args.host, args.port))
+        exit(1)
+
+    period = 1.0 / args.rate if args.rate > 0 else 0
+    all_lat = []
+    errors = 0
+    tx_adu = rx_adu = tx_wire = rx_wire = 0
+    total = 0
+
+    t0 = time.perf_counter()
+    tend = t0 + args.duration
+    try:
+        while not (args.requests and total >= args.requests):
+            sched = t0 + total * period
+            if period:
+                delay = sched - time.perf_counter()
+                if delay > 0:
+                    time.sleep(delay)
+            if time.perf_counter() >= tend:
+                break
+
+            entry = random.choices(mix, weights)[0]
+            addr = args.addr + (random.randrange(args.span) if args.span else 0)
+
+            start = time.perf_counter()
+            try:
+                rsp = transact(client, entry, addr, args.unit, total)
+            except Exception:
+                rsp = None
+            done = time.perf_counter()
+            total += 1
+
+            if rsp is None or not hasattr(rsp, 'function_code'):
+                errors += 1
+                client.close()
+                client.connect()
+                continue
+
+            req_len, rsp_len = adu_sizes(entry['fc'], entry['qty'])
+            if rsp.isError():
+                entry['exc'] += 1
+                rsp_len = 9
+            lat = done - (sched if period else start)
+            entry['lat'].append(lat)
+            all_lat.append(lat)
+            tx_adu += req_len
+            rx_adu += rsp_len
+            tx_wire += wire(req_len)
+            rx_wire += wire(rsp_len)
+    except KeyboardInterrupt:
+        pass
+    secs = time.perf_counter() - t0
+    client.close()
+
+    all_lat.sort()
+    n = len(all_lat)
+    print('requests        : %d (%d errors)' % (total, errors))
+    print('duration        : %.3f s' % secs)
+    print('throughput      : %.1f req/s' % (n / secs))
+    print('latency us      : p50 %.2f  p99 %.2f  p999 %.2f  max %.2f' %
+          (pct(all_lat, 0.5), pct(all_lat, 0.99), pct(all_lat, 0.999), pct(all_lat, 1.0)))
+    if n:
+        print('ADU bytes       : tx %d  rx %d  (%.1f per request)' % (tx_adu, rx_adu, (tx_adu + rx_adu) / n))
+        print('wire bytes      : tx %d  rx %d  (%.1f per request)' % (tx_wire, rx_wire, (tx_wire + rx_wire) / n))
+    for m in mix:
+        m['lat'].sort()
+        print('FC%02d qty %-5d  : %8d req  %6d exc  p50 %.2f  p99 %.2f us' %
+              (m['fc'], m['qty'], len(m['lat']), m['exc'], pct(m['lat'], 0.5), pct(m['lat'], 0.99)))
+    exit(2 if errors else 0)
+
+
+if __name__ == '__main__':
+    main()
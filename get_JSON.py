@@ -1,3 +1,4 @@
+import sys
 import requests
 import time
 import json
@@ -45,7 +46,8 @@ def fetch_json_with_retries(url, max_retries=5, timeout=5, backoff_factor=1):
     return None
 
 # Main loop to continuously fetch JSON
-url = 'http://192.168.1.10/json.html'
+# Optional argument: URL, e.g. http://127.0.0.1:10080/json.html for the Host build
+url = sys.argv[1] if len(sys.argv) > 1 else 'http://192.168.1.10/json.html'
 interval = 0.1  # Interval between fetch attempts
 
 try:
@@ -1,5 +1,6 @@
 
 import os
+import sys
 import time
 import pickle
 import socket
@@ -75,7 +76,9 @@ for i in range(40+1):
 
 
 
-hardserverIP = '192.168.1.10'
+# Optional arguments: server IP and port, e.g. 127.0.0.1 10502 for the Host build
+hardserverIP = sys.argv[1] if len(sys.argv) > 1 else '192.168.1.10'
+hardserverPORT = int(sys.argv[2]) if len(sys.argv) > 2 else 502
 
 
 
@@ -92,7 +95,7 @@ builder.add_16bit_uint(1)
 builder.add_16bit_uint(1)
 relayDataPacket1 = builder.build()            
 try:
-    MBServ = ModbusTcpClient(host=hardserverIP, port=502)
+    MBServ = ModbusTcpClient(host=hardserverIP, port=hardserverPORT)
     MBServ.connect()
     res = MBServ.write_registers(30, relayDataPacket1, skip_encode = True, unit = 8)
     time.sleep(0.1)
@@ -109,7 +112,7 @@ try:
     while True:
         
         try:
-            MBServ = ModbusTcpClient(host=hardserverIP, port=502)
+            MBServ = ModbusTcpClient(host=hardserverIP, port=hardserverPORT)
             MBServ.connect()
             # Read data from MODULES
             digital_MODULES = MBServ.read_coils(0, 64, unit=2)
@@ -125,7 +128,7 @@ try:
 
 
         try:
-            MBServ = ModbusTcpClient(host=hardserverIP, port=502)
+            MBServ = ModbusTcpClient(host=hardserverIP, port=hardserverPORT)
             MBServ.connect()
             # Read data from MODULES
             analog_MODULES = MBServ.read_holding_registers(0, 40, unit=2)   # address, count, slave address
@@ -240,7 +243,7 @@ except KeyboardInterrupt:
         builder.add_16bit_uint(k8)
         relayDataPacket1 = builder.build()            
         try:
-            MBServ = ModbusTcpClient(host=hardserverIP, port=502)
+            MBServ = ModbusTcpClient(host=hardserverIP, port=hardserverPORT)
             MBServ.connect()
             res = MBServ.write_registers(30, relayDataPacket1, skip_encode = True, unit = 8)
             time.sleep(0.1)
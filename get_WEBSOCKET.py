@@ -8,6 +8,7 @@ exceptions that occur during message sending. This helps in diagnosing issues wi
 Graceful Exit: Added a finally block to ensure the WebSocket is properly closed even if an interrupt occurs.
 '''
 
+import sys
 import websocket
 import time
 import threading
@@ -44,7 +45,9 @@ def on_open(ws):
     message_thread.start()
 
 if __name__ == "__main__":
-    ws = websocket.WebSocketApp("ws://192.168.1.10:8088/echo",
+    # Optional argument: URL, e.g. ws://127.0.0.1:18088/echo for the Host build
+    url = sys.argv[1] if len(sys.argv) > 1 else "ws://192.168.1.10:8088/echo"
+    ws = websocket.WebSocketApp(url,
     #ws = websocket.WebSocketApp("ws://localhost:8088/echo",
                                 on_message=on_message,
                                 on_error=on_error,